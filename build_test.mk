@@ -51,6 +51,12 @@ include common_features.mk
 include $(TMK_PATH)/common.mk
 include $(QUANTUM_PATH)/sequencer/tests/rules.mk
 include $(QUANTUM_PATH)/serial_link/tests/rules.mk
+include $(QUANTUM_PATH)/split_common/tests/rules.mk
+include $(QUANTUM_PATH)/rgb_matrix_animations/tests/rules.mk
+include $(TMK_PATH)/common/chibios/tests/rules.mk
+include $(DRIVER_PATH)/oled/tests/rules.mk
+include $(QUANTUM_PATH)/encoder/tests/rules.mk
+include $(QUANTUM_PATH)/audio/tests/rules.mk
 ifneq ($(filter $(FULL_TESTS),$(TEST)),)
 include build_full_test.mk
 endif
@@ -70,6 +70,9 @@ ifeq ($(strip $(AUDIO_ENABLE)), yes)
     SRC += $(QUANTUM_DIR)/audio/driver_$(PLATFORM_KEY)_$(strip $(AUDIO_DRIVER)).c
     SRC += $(QUANTUM_DIR)/audio/voices.c
     SRC += $(QUANTUM_DIR)/audio/luts.c
+    ifeq ($(strip $(AUDIO_DRIVER)), dac_additive)
+        SRC += $(QUANTUM_DIR)/audio/wavetable.c
+    endif
 endif
 
 ifeq ($(strip $(SEQUENCER_ENABLE)), yes)
@@ -126,12 +129,12 @@ else
     OPT_DEFS += -DEEPROM_DRIVER -DEEPROM_I2C
     COMMON_VPATH += $(DRIVER_PATH)/eeprom
     QUANTUM_LIB_SRC += i2c_master.c
-    SRC += eeprom_driver.c eeprom_i2c.c
+    SRC += eeprom_driver.c eeprom_page_cache.c eeprom_i2c.c
   else ifeq ($(strip $(EEPROM_DRIVER)), spi)
     OPT_DEFS += -DEEPROM_DRIVER -DEEPROM_SPI
     COMMON_VPATH += $(DRIVER_PATH)/eeprom
     QUANTUM_LIB_SRC += spi_master.c
-    SRC += eeprom_driver.c eeprom_spi.c
+    SRC += eeprom_driver.c eeprom_page_cache.c eeprom_spi.c
   else ifeq ($(strip $(EEPROM_DRIVER)), transient)
     OPT_DEFS += -DEEPROM_DRIVER -DEEPROM_TRANSIENT
     COMMON_VPATH += $(DRIVER_PATH)/eeprom
@@ -205,6 +208,7 @@ ifeq ($(strip $(RGBLIGHT_ENABLE)), yes)
     endif
 
     ifeq ($(strip $(RGBLIGHT_DRIVER)), WS2812)
+        OPT_DEFS += -DRGBLIGHT_WS2812
         WS2812_DRIVER_REQUIRED := yes
     endif
 
@@ -234,6 +238,7 @@ endif
     SRC += $(QUANTUM_DIR)/led_matrix.c
     SRC += $(QUANTUM_DIR)/led_matrix_drivers.c
     CIE1931_CURVE := yes
+    LIGHTING_CORE_REQUIRED := yes
 
     ifeq ($(strip $(LED_MATRIX_DRIVER)), IS31FL3731)
         OPT_DEFS += -DIS31FL3731 -DSTM32_I2C -DHAL_USE_I2C=TRUE
@@ -260,6 +265,7 @@ endif
     SRC += $(QUANTUM_DIR)/rgb_matrix_drivers.c
     CIE1931_CURVE := yes
     RGB_KEYCODES_ENABLE := yes
+    LIGHTING_CORE_REQUIRED := yes
 
     ifeq ($(strip $(RGB_MATRIX_DRIVER)), IS31FL3731)
         OPT_DEFS += -DIS31FL3731 -DSTM32_I2C -DHAL_USE_I2C=TRUE
@@ -308,6 +314,10 @@ endif
     endif
 endif
 
+ifeq ($(strip $(LIGHTING_CORE_REQUIRED)), yes)
+    SRC += $(QUANTUM_DIR)/lighting_core.c
+endif
+
 ifeq ($(strip $(RGB_KEYCODES_ENABLE)), yes)
     SRC += $(QUANTUM_DIR)/process_keycode/process_rgb.c
 endif
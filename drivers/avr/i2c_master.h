@@ -41,3 +41,9 @@ i2c_status_t i2c_receive(uint8_t address, uint8_t* data, uint16_t length, uint16
 i2c_status_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout);
 i2c_status_t i2c_readReg(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout);
 void         i2c_stop(void);
+
+// There is no transaction queue on AVR, so these write straight away and
+// report the result immediately
+static inline i2c_status_t i2c_transmit_async(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout) { return i2c_transmit(address, data, length, timeout); }
+static inline i2c_status_t i2c_writeReg_async(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout) { return i2c_writeReg(devaddr, regaddr, data, length, timeout); }
+static inline i2c_status_t i2c_async_status(uint8_t address) { return I2C_STATUS_SUCCESS; }
@@ -52,6 +52,32 @@ spi_status_t spi_transmit(const uint8_t *data, uint16_t length);
 spi_status_t spi_receive(uint8_t *data, uint16_t length);
 
 void spi_stop(void);
+
+// There is no transfer queue on AVR, so devices just remember their
+// settings and spi_transmit_async() sends straight away
+typedef struct {
+    pin_t    slave_pin;
+    bool     lsb_first;
+    uint8_t  mode;
+    uint16_t divisor;
+} spi_device_t;
+
+static inline bool spi_device_init(spi_device_t *device, pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor) {
+    device->slave_pin = slavePin;
+    device->lsb_first = lsbFirst;
+    device->mode      = mode;
+    device->divisor   = divisor;
+    return slavePin != NO_PIN;
+}
+
+static inline spi_status_t spi_transmit_async(spi_device_t *device, const uint8_t *data, uint16_t length) {
+    if (!spi_start(device->slave_pin, device->lsb_first, device->mode, device->divisor)) {
+        return SPI_STATUS_ERROR;
+    }
+    spi_status_t status = spi_transmit(data, length);
+    spi_stop();
+    return status;
+}
 #ifdef __cplusplus
 }
 #endif
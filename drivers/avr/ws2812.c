@@ -47,6 +47,29 @@ void ws2812_setleds(LED_TYPE *ledarray, uint16_t number_of_leds) {
     _delay_us(WS2812_TRST_US);
 }
 
+void ws2812_setleds_mapped(LED_TYPE *ledarray, const uint8_t *led_map, uint16_t number_of_leds) {
+    DDRx_ADDRESS(RGB_DI_PIN) |= pinmask(RGB_DI_PIN);
+
+    uint8_t masklo = ~(pinmask(RGB_DI_PIN)) & PORTx_ADDRESS(RGB_DI_PIN);
+    uint8_t maskhi = pinmask(RGB_DI_PIN) | PORTx_ADDRESS(RGB_DI_PIN);
+
+    // LEDs are sent one at a time, so keep interrupts off in between as well,
+    // or a long one could stretch a gap into a reset
+    uint8_t sreg_prev = SREG;
+    cli();
+
+    for (uint16_t i = 0; i < number_of_leds; i++) {
+        LED_TYPE color = ws2812_mapped_led(ledarray, led_map, i);
+        ws2812_sendarray_mask((uint8_t *)&color, sizeof(LED_TYPE), masklo, maskhi);
+    }
+
+    SREG = sreg_prev;
+
+    _delay_us(WS2812_TRST_US);
+}
+
+bool ws2812_flush_complete(void) { return true; }
+
 /*
   This routine writes an array of bytes with RGB values to the Dataout pin
   using the fast 800kHz clockless WS2811/2812 protocol.
@@ -25,3 +25,19 @@ void ws2812_setleds(LED_TYPE *ledarray, uint16_t leds) {
 
     i2c_transmit(WS2812_ADDRESS, (uint8_t *)ledarray, sizeof(LED_TYPE) * leds, WS2812_TIMEOUT);
 }
+
+// The LEDs go out in a single transfer, so a remapped strip is sent from a copy
+void ws2812_setleds_mapped(LED_TYPE *ledarray, const uint8_t *led_map, uint16_t leds) {
+    if (!led_map) {
+        ws2812_setleds(ledarray, leds);
+        return;
+    }
+
+    LED_TYPE mapped[leds];
+    for (uint16_t i = 0; i < leds; i++) {
+        mapped[i] = ws2812_mapped_led(ledarray, led_map, i);
+    }
+    ws2812_setleds(mapped, leds);
+}
+
+bool ws2812_flush_complete(void) { return true; }
@@ -108,30 +108,112 @@
 #    endif
 #endif
 
+#ifdef ADC_CONTINUOUS_PINS
+// Samples of each channel averaged into one result. Each half of the DMA
+// buffer holds one round of them, so results arrive at the conversion rate
+// divided by the number of channels times this.
+#    ifndef ADC_OVERSAMPLING
+#        define ADC_OVERSAMPLING 16
+#    endif
+
+// Each result moves the filtered value 1/2^N of the way there, 0 disables
+// the filter.
+#    ifndef ADC_FILTER_SHIFT
+#        define ADC_FILTER_SHIFT 2
+#    endif
+
+// The longest sample time keeps the interrupt rate down, and suits the
+// high impedance of pots and sensors.
+#    ifndef ADC_CONTINUOUS_SAMPLING_RATE
+#        if defined(ADC_SMPR_SMP_601P5)
+#            define ADC_CONTINUOUS_SAMPLING_RATE ADC_SMPR_SMP_601P5
+#        elif defined(ADC_SMPR_SMP_640P5)
+#            define ADC_CONTINUOUS_SAMPLING_RATE ADC_SMPR_SMP_640P5
+#        elif defined(ADC_SMPR_SMP_239P5)
+#            define ADC_CONTINUOUS_SAMPLING_RATE ADC_SMPR_SMP_239P5
+#        else
+#            define ADC_CONTINUOUS_SAMPLING_RATE ADC_SAMPLING_RATE
+#        endif
+#    endif
+
+// How long the first read waits for the first result
+#    ifndef ADC_CONTINUOUS_TIMEOUT
+#        define ADC_CONTINUOUS_TIMEOUT 10
+#    endif
+#endif
+
 static ADCConfig   adcCfg = {};
 static adcsample_t sampleBuffer[ADC_NUM_CHANNELS * ADC_BUFFER_DEPTH];
 
 // Initialize to max number of ADCs, set to empty object to initialize all to false.
 static bool adcInitialized[ADC_COUNT] = {};
 
+// Sample time fields of a conversion group, for every channel
+// clang-format off
+#if defined(USE_ADCV1)
+#    define ADC_SAMPLE_TIMES(rate) .smpr = (rate)
+#elif defined(USE_ADCV2)
+#    define ADC_SAMPLE_TIMES(rate) \
+        .smpr2 = ADC_SMPR2_SMP_AN0(rate) | ADC_SMPR2_SMP_AN1(rate) | ADC_SMPR2_SMP_AN2(rate) | ADC_SMPR2_SMP_AN3(rate) | ADC_SMPR2_SMP_AN4(rate) | ADC_SMPR2_SMP_AN5(rate) | ADC_SMPR2_SMP_AN6(rate) | ADC_SMPR2_SMP_AN7(rate) | ADC_SMPR2_SMP_AN8(rate) | ADC_SMPR2_SMP_AN9(rate), \
+        .smpr1 = ADC_SMPR1_SMP_AN10(rate) | ADC_SMPR1_SMP_AN11(rate) | ADC_SMPR1_SMP_AN12(rate) | ADC_SMPR1_SMP_AN13(rate) | ADC_SMPR1_SMP_AN14(rate) | ADC_SMPR1_SMP_AN15(rate)
+#else
+#    define ADC_SAMPLE_TIMES(rate) .smpr = {ADC_SMPR1_SMP_AN0(rate) | ADC_SMPR1_SMP_AN1(rate) | ADC_SMPR1_SMP_AN2(rate) | ADC_SMPR1_SMP_AN3(rate) | ADC_SMPR1_SMP_AN4(rate) | ADC_SMPR1_SMP_AN5(rate) | ADC_SMPR1_SMP_AN6(rate) | ADC_SMPR1_SMP_AN7(rate) | ADC_SMPR1_SMP_AN8(rate) | ADC_SMPR1_SMP_AN9(rate), ADC_SMPR2_SMP_AN10(rate) | ADC_SMPR2_SMP_AN11(rate) | ADC_SMPR2_SMP_AN12(rate) | ADC_SMPR2_SMP_AN13(rate) | ADC_SMPR2_SMP_AN14(rate) | ADC_SMPR2_SMP_AN15(rate) | ADC_SMPR2_SMP_AN16(rate) | ADC_SMPR2_SMP_AN17(rate) | ADC_SMPR2_SMP_AN18(rate)}
+#endif
+// clang-format on
+
 // TODO: add back TR handling???
 static ADCConversionGroup adcConversionGroup = {
     .circular     = FALSE,
     .num_channels = (uint16_t)(ADC_NUM_CHANNELS),
 #if defined(USE_ADCV1)
     .cfgr1 = ADC_CFGR1_CONT | ADC_RESOLUTION,
-    .smpr  = ADC_SAMPLING_RATE,
 #elif defined(USE_ADCV2)
 #    if !defined(STM32F1XX)
     .cr2 = ADC_CR2_SWSTART,  // F103 seem very unhappy with, F401 seems very unhappy without...
 #    endif
-    .smpr2 = ADC_SMPR2_SMP_AN0(ADC_SAMPLING_RATE) | ADC_SMPR2_SMP_AN1(ADC_SAMPLING_RATE) | ADC_SMPR2_SMP_AN2(ADC_SAMPLING_RATE) | ADC_SMPR2_SMP_AN3(ADC_SAMPLING_RATE) | ADC_SMPR2_SMP_AN4(ADC_SAMPLING_RATE) | ADC_SMPR2_SMP_AN5(ADC_SAMPLING_RATE) | ADC_SMPR2_SMP_AN6(ADC_SAMPLING_RATE) | ADC_SMPR2_SMP_AN7(ADC_SAMPLING_RATE) | ADC_SMPR2_SMP_AN8(ADC_SAMPLING_RATE) | ADC_SMPR2_SMP_AN9(ADC_SAMPLING_RATE),
-    .smpr1 = ADC_SMPR1_SMP_AN10(ADC_SAMPLING_RATE) | ADC_SMPR1_SMP_AN11(ADC_SAMPLING_RATE) | ADC_SMPR1_SMP_AN12(ADC_SAMPLING_RATE) | ADC_SMPR1_SMP_AN13(ADC_SAMPLING_RATE) | ADC_SMPR1_SMP_AN14(ADC_SAMPLING_RATE) | ADC_SMPR1_SMP_AN15(ADC_SAMPLING_RATE),
 #else
     .cfgr = ADC_CFGR_CONT | ADC_RESOLUTION,
-    .smpr = {ADC_SMPR1_SMP_AN0(ADC_SAMPLING_RATE) | ADC_SMPR1_SMP_AN1(ADC_SAMPLING_RATE) | ADC_SMPR1_SMP_AN2(ADC_SAMPLING_RATE) | ADC_SMPR1_SMP_AN3(ADC_SAMPLING_RATE) | ADC_SMPR1_SMP_AN4(ADC_SAMPLING_RATE) | ADC_SMPR1_SMP_AN5(ADC_SAMPLING_RATE) | ADC_SMPR1_SMP_AN6(ADC_SAMPLING_RATE) | ADC_SMPR1_SMP_AN7(ADC_SAMPLING_RATE) | ADC_SMPR1_SMP_AN8(ADC_SAMPLING_RATE) | ADC_SMPR1_SMP_AN9(ADC_SAMPLING_RATE), ADC_SMPR2_SMP_AN10(ADC_SAMPLING_RATE) | ADC_SMPR2_SMP_AN11(ADC_SAMPLING_RATE) | ADC_SMPR2_SMP_AN12(ADC_SAMPLING_RATE) | ADC_SMPR2_SMP_AN13(ADC_SAMPLING_RATE) | ADC_SMPR2_SMP_AN14(ADC_SAMPLING_RATE) | ADC_SMPR2_SMP_AN15(ADC_SAMPLING_RATE) | ADC_SMPR2_SMP_AN16(ADC_SAMPLING_RATE) | ADC_SMPR2_SMP_AN17(ADC_SAMPLING_RATE) | ADC_SMPR2_SMP_AN18(ADC_SAMPLING_RATE)},
 #endif
+    ADC_SAMPLE_TIMES(ADC_SAMPLING_RATE),
+};
+
+#ifdef ADC_CONTINUOUS_PINS
+static const pin_t continuousPins[] = ADC_CONTINUOUS_PINS;
+#    define ADC_CONTINUOUS_COUNT (sizeof(continuousPins) / sizeof(continuousPins[0]))
+_Static_assert(ADC_CONTINUOUS_COUNT <= 16, "ADC_CONTINUOUS_PINS can hold at most 16 pins.");
+
+static adcsample_t continuousBuffer[ADC_CONTINUOUS_COUNT * ADC_OVERSAMPLING * 2];
+// Filtered values, scaled up by ADC_FILTER_SHIFT
+static uint32_t         continuousFilter[ADC_CONTINUOUS_COUNT];
+static volatile int16_t continuousValue[ADC_CONTINUOUS_COUNT];
+// Position of each pin in the scan, 0xFF if it is on another ADC
+static uint8_t            continuousSlot[ADC_CONTINUOUS_COUNT];
+static uint8_t            continuousAdc;
+static ADCDriver*         continuousDriver;
+static volatile bool      continuousRunning;
+static volatile bool      continuousReady;
+static thread_reference_t continuousWaiter;
+
+static void continuousEndCallback(ADCDriver* adcp);
+static void continuousErrorCallback(ADCDriver* adcp, adcerror_t err);
+
+static ADCConversionGroup continuousGroup = {
+    .circular = TRUE,
+    .end_cb   = continuousEndCallback,
+    .error_cb = continuousErrorCallback,
+#    if defined(USE_ADCV1)
+    .cfgr1 = ADC_CFGR1_CONT | ADC_RESOLUTION,
+#    elif defined(USE_ADCV2)
+    .cr1 = ADC_CR1_SCAN,
+#        if !defined(STM32F1XX)
+    .cr2 = ADC_CR2_SWSTART,
+#        endif
+#    else
+    .cfgr = ADC_CFGR_CONT | ADC_RESOLUTION,
+#    endif
+    ADC_SAMPLE_TIMES(ADC_CONTINUOUS_SAMPLING_RATE),
 };
+#endif
 
 // clang-format off
 __attribute__((weak)) adc_mux pinToMux(pin_t pin) {
@@ -277,13 +359,175 @@ static inline void manageAdcInitializationDriver(uint8_t adc, ADCDriver* adcDriv
     }
 }
 
+#ifdef ADC_CONTINUOUS_PINS
+// Adds mux to the scan at position
+static void continuousSelect(uint8_t position, adc_mux mux) {
+#    if defined(USE_ADCV1)
+    // Channels are always scanned in ascending order, so the position is implied
+    continuousGroup.chselr |= 1 << mux.input;
+#    elif defined(USE_ADCV2)
+    uint32_t sq = (uint32_t)mux.input << (5 * (position % 6));
+    if (position < 6) {
+        continuousGroup.sqr3 |= sq;
+    } else if (position < 12) {
+        continuousGroup.sqr2 |= sq;
+    } else {
+        continuousGroup.sqr1 |= sq;
+    }
+#    else
+    // SQ1 starts at bit 6 of SQR1, after the sequence length
+    continuousGroup.sqr[(position + 1) / 5] |= (uint32_t)mux.input << (6 * ((position + 1) % 5));
+#    endif
+}
+
+static bool continuousPrepare(void) {
+    continuousAdc    = pinToMux(continuousPins[0]).adc;
+    continuousDriver = intToADCDriver(continuousAdc);
+    if (!continuousDriver) {
+        return false;
+    }
+
+    uint8_t channels = 0;
+    for (uint8_t i = 0; i < ADC_CONTINUOUS_COUNT; i++) {
+        adc_mux mux = pinToMux(continuousPins[i]);
+        if (mux.adc != continuousAdc) {
+            continuousSlot[i] = 0xFF;
+            continue;
+        }
+        palSetLineMode(continuousPins[i], PAL_MODE_INPUT_ANALOG);
+        continuousSlot[i] = channels++;
+        continuousSelect(continuousSlot[i], mux);
+    }
+#    if defined(USE_ADCV1)
+    for (uint8_t i = 0; i < ADC_CONTINUOUS_COUNT; i++) {
+        if (continuousSlot[i] == 0xFF) {
+            continue;
+        }
+        continuousSlot[i] = 0;
+        for (uint8_t j = 0; j < ADC_CONTINUOUS_COUNT; j++) {
+            if (continuousSlot[j] != 0xFF && pinToMux(continuousPins[j]).input < pinToMux(continuousPins[i]).input) {
+                continuousSlot[i]++;
+            }
+        }
+    }
+#    elif defined(USE_ADCV2)
+    // The F1 driver copies sqr1 as is, so the sequence length has to be part
+    // of it. The F2 and F4 driver adds the same bits itself.
+    continuousGroup.sqr1 |= ADC_SQR1_NUM_CH(channels);
+#    endif
+    continuousGroup.num_channels = channels;
+    return true;
+}
+
+// Runs from the DMA interrupt, once for each half of the buffer
+static void continuousEndCallback(ADCDriver* adcp) {
+    uint16_t           channels = continuousGroup.num_channels;
+    const adcsample_t* samples  = continuousBuffer;
+    if (adcIsBufferComplete(adcp)) {
+        samples += channels * ADC_OVERSAMPLING;
+    }
+
+    for (uint8_t i = 0; i < ADC_CONTINUOUS_COUNT; i++) {
+        if (continuousSlot[i] == 0xFF) {
+            continue;
+        }
+        uint32_t sum = 0;
+        for (uint16_t n = 0; n < ADC_OVERSAMPLING; n++) {
+            sum += samples[n * channels + continuousSlot[i]];
+        }
+        uint32_t value = sum / ADC_OVERSAMPLING;
+#    ifdef USE_ADCV2
+        // fake 12-bit -> N-bit scale
+        value >>= 12 - ADC_RESOLUTION;
+#    endif
+        if (continuousReady) {
+            continuousFilter[i] += value - (continuousFilter[i] >> ADC_FILTER_SHIFT);
+        } else {
+            continuousFilter[i] = value << ADC_FILTER_SHIFT;
+        }
+        continuousValue[i] = continuousFilter[i] >> ADC_FILTER_SHIFT;
+    }
+
+    chSysLockFromISR();
+    continuousReady = true;
+    chThdResumeI(&continuousWaiter, MSG_OK);
+    chSysUnlockFromISR();
+}
+
+// The driver stops on errors, the next read starts it again
+static void continuousErrorCallback(ADCDriver* adcp, adcerror_t err) { continuousRunning = false; }
+
+void analogStartContinuous(void) {
+    if (continuousRunning) {
+        return;
+    }
+    if (!continuousDriver && !continuousPrepare()) {
+        return;
+    }
+
+    manageAdcInitializationDriver(continuousAdc, continuousDriver);
+    continuousRunning = true;
+    adcStartConversion(continuousDriver, &continuousGroup, continuousBuffer, ADC_OVERSAMPLING * 2);
+}
+
+void analogStopContinuous(void) {
+    if (continuousRunning) {
+        adcStopConversion(continuousDriver);
+        continuousRunning = false;
+    }
+}
+
+// Returns the index of pin in ADC_CONTINUOUS_PINS when it is sampled on
+// adc, or -1. An adc of 0xFF matches the one pinToMux() picks.
+static int8_t continuousIndex(pin_t pin, uint8_t adc) {
+    for (uint8_t i = 0; i < ADC_CONTINUOUS_COUNT; i++) {
+        if (continuousPins[i] != pin) {
+            continue;
+        }
+        analogStartContinuous();
+        if (!continuousRunning || continuousSlot[i] == 0xFF || (adc != 0xFF && adc != continuousAdc)) {
+            return -1;
+        }
+        return i;
+    }
+    return -1;
+}
+
+static int16_t continuousRead(int8_t index) {
+    if (!continuousReady) {
+        chSysLock();
+        if (!continuousReady) {
+            chThdSuspendTimeoutS(&continuousWaiter, TIME_MS2I(ADC_CONTINUOUS_TIMEOUT));
+        }
+        chSysUnlock();
+    }
+    return continuousValue[index];
+}
+
+bool analogPinIsContinuous(pin_t pin) { return continuousIndex(pin, 0xFF) >= 0; }
+#endif
+
 int16_t analogReadPin(pin_t pin) {
+#ifdef ADC_CONTINUOUS_PINS
+    int8_t index = continuousIndex(pin, 0xFF);
+    if (index >= 0) {
+        return continuousRead(index);
+    }
+#endif
+
     palSetLineMode(pin, PAL_MODE_INPUT_ANALOG);
 
     return adc_read(pinToMux(pin));
 }
 
 int16_t analogReadPinAdc(pin_t pin, uint8_t adc) {
+#ifdef ADC_CONTINUOUS_PINS
+    int8_t index = continuousIndex(pin, adc);
+    if (index >= 0) {
+        return continuousRead(index);
+    }
+#endif
+
     palSetLineMode(pin, PAL_MODE_INPUT_ANALOG);
 
     adc_mux target = pinToMux(pin);
@@ -307,7 +551,20 @@ int16_t adc_read(adc_mux mux) {
     }
 
     manageAdcInitializationDriver(mux.adc, targetDriver);
-    if (adcConvert(targetDriver, &adcConversionGroup, &sampleBuffer[0], ADC_BUFFER_DEPTH) != MSG_OK) {
+#ifdef ADC_CONTINUOUS_PINS
+    // Pause background sampling on the same ADC for the one-off conversion
+    bool resume = continuousRunning && targetDriver == continuousDriver;
+    if (resume) {
+        analogStopContinuous();
+    }
+#endif
+    msg_t status = adcConvert(targetDriver, &adcConversionGroup, &sampleBuffer[0], ADC_BUFFER_DEPTH);
+#ifdef ADC_CONTINUOUS_PINS
+    if (resume) {
+        analogStartContinuous();
+    }
+#endif
+    if (status != MSG_OK) {
         return 0;
     }
 
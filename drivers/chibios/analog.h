@@ -36,6 +36,15 @@ adc_mux pinToMux(pin_t pin);
 
 int16_t adc_read(adc_mux mux);
 
+#ifdef ADC_CONTINUOUS_PINS
+// Pins in ADC_CONTINUOUS_PINS are scanned in the background, and reading
+// them returns the latest filtered value without waiting for a conversion.
+// The first read starts the scan.
+void analogStartContinuous(void);
+void analogStopContinuous(void);
+bool analogPinIsContinuous(pin_t pin);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
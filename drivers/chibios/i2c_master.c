@@ -77,45 +77,252 @@ __attribute__((weak)) void i2c_init(void) {
     }
 }
 
-i2c_status_t i2c_start(uint8_t address) {
-    i2c_address = address;
-    i2cStart(&I2C_DRIVER, &i2cconfig);
+static THD_WORKING_AREA(waI2CThread, I2C_THREAD_STACK_SIZE);
+static thread_t*          i2c_thread         = NULL;
+static thread_reference_t i2c_thread_waiting = NULL;
+
+// Transactions waiting for the bus, linked through their next pointer
+static i2c_transaction_t* i2c_queue_head = NULL;
+static i2c_transaction_t* i2c_queue_tail = NULL;
+
+// Transactions for i2c_transmit_async(), with their data copied into a ring
+// buffer. Everything on the bus finishes in order, so both are freed from the
+// oldest end.
+static i2c_transaction_t i2c_async_slots[I2C_ASYNC_QUEUE_SIZE];
+static uint8_t           i2c_async_buffer[I2C_ASYNC_BUFFER_SIZE];
+static uint8_t           i2c_async_head      = 0;
+static uint8_t           i2c_async_count     = 0;
+static uint16_t          i2c_async_data_head = 0;
+static uint16_t          i2c_async_data_tail = 0;
+
+// Async failures per 7 bit device address, until i2c_async_status() reads them
+static uint32_t i2c_async_errors[4]   = {0};
+static uint32_t i2c_async_timeouts[4] = {0};
+
+static THD_FUNCTION(I2CThread, arg) {
+    (void)arg;
+    chRegSetThreadName("i2c");
+
+    while (true) {
+        chSysLock();
+        while (!i2c_queue_head) {
+            chThdSuspendS(&i2c_thread_waiting);
+        }
+        i2c_transaction_t* txn = i2c_queue_head;
+        i2c_queue_head         = txn->next;
+        if (!i2c_queue_head) {
+            i2c_queue_tail = NULL;
+        }
+        chSysUnlock();
+
+        // Empty transactions only mark a point in the queue, and never reach the bus
+        i2c_status_t result = I2C_STATUS_SUCCESS;
+        if (txn->tx_length > 0 || txn->rx_length > 0) {
+            i2c_address = txn->address;
+            i2cStart(&I2C_DRIVER, &i2cconfig);
+            msg_t status;
+            if (txn->tx_length > 0) {
+                status = i2cMasterTransmitTimeout(&I2C_DRIVER, (i2c_address >> 1), txn->tx_data, txn->tx_length, txn->rx_data, txn->rx_length, TIME_MS2I(txn->timeout));
+            } else {
+                status = i2cMasterReceiveTimeout(&I2C_DRIVER, (i2c_address >> 1), txn->rx_data, txn->rx_length, TIME_MS2I(txn->timeout));
+            }
+            result = chibios_to_qmk(&status);
+        }
+
+        if (txn->callback) {
+            txn->callback(txn, result);
+        }
+
+        chSysLock();
+        if (txn->buffer_end) {
+            i2c_async_data_tail = txn->buffer_end % I2C_ASYNC_BUFFER_SIZE;
+            i2c_async_count--;
+            uint8_t device = (txn->address >> 1) & 0x7F;
+            if (result == I2C_STATUS_TIMEOUT) {
+                i2c_async_timeouts[device / 32] |= 1UL << (device % 32);
+            } else if (result != I2C_STATUS_SUCCESS) {
+                i2c_async_errors[device / 32] |= 1UL << (device % 32);
+            }
+        }
+        txn->status = result;
+        chThdResumeS(&txn->waiter, MSG_OK);
+        chSysUnlock();
+    }
+}
+
+static void i2c_queue(i2c_transaction_t* txn) {
+    if (!i2c_thread) {
+        i2c_thread = chThdCreateStatic(waI2CThread, sizeof(waI2CThread), NORMALPRIO + 1, I2CThread, NULL);
+    }
+
+    txn->status = I2C_STATUS_PENDING;
+    txn->waiter = NULL;
+    txn->next   = NULL;
+
+    chSysLock();
+    if (i2c_queue_tail) {
+        i2c_queue_tail->next = txn;
+    } else {
+        i2c_queue_head = txn;
+    }
+    i2c_queue_tail = txn;
+    chThdResumeS(&i2c_thread_waiting, MSG_OK);
+    chSysUnlock();
+}
+
+void i2c_submit(i2c_transaction_t* txn) {
+    txn->buffer_end = 0;
+    i2c_queue(txn);
+}
+
+bool i2c_done(const i2c_transaction_t* txn) { return txn->status != I2C_STATUS_PENDING; }
+
+i2c_status_t i2c_wait(i2c_transaction_t* txn) {
+    chSysLock();
+    if (txn->status == I2C_STATUS_PENDING) {
+        chThdSuspendS(&txn->waiter);
+    }
+    chSysUnlock();
+    return txn->status;
+}
+
+void i2c_wait_idle(void) {
+    // Queue an empty marker behind everything else and wait for it
+    i2c_transaction_t marker = {.address = i2c_address};
+    if (i2c_thread) {
+        i2c_submit(&marker);
+        i2c_wait(&marker);
+    }
+}
+
+// Finds room for length bytes in the ring buffer, waiting for the oldest
+// async transfer to finish while there is none.
+static i2c_transaction_t* i2c_async_alloc(uint16_t length, uint8_t** data) {
+    if (length == 0 || length > I2C_ASYNC_BUFFER_SIZE) {
+        return NULL;
+    }
+
+    while (true) {
+        chSysLock();
+        uint16_t start = i2c_async_data_head;
+        bool     fits  = false;
+        if (i2c_async_count == 0) {
+            start               = 0;
+            i2c_async_data_tail = 0;
+            fits                = true;
+        } else if (i2c_async_count < I2C_ASYNC_QUEUE_SIZE) {
+            if (i2c_async_data_tail < i2c_async_data_head) {
+                if (start + length > I2C_ASYNC_BUFFER_SIZE) {
+                    start = 0;
+                }
+                fits = start == 0 ? length <= i2c_async_data_tail : true;
+            } else {
+                fits = start + length <= i2c_async_data_tail;
+            }
+        }
+
+        if (fits) {
+            i2c_transaction_t* txn = &i2c_async_slots[i2c_async_head];
+            i2c_async_head         = (i2c_async_head + 1) % I2C_ASYNC_QUEUE_SIZE;
+            i2c_async_count++;
+            i2c_async_data_head = (start + length) % I2C_ASYNC_BUFFER_SIZE;
+            chSysUnlock();
+
+            // buffer_end is never 0, it marks the transaction as owned by the queue
+            txn->buffer_end = start + length;
+            *data           = &i2c_async_buffer[start];
+            return txn;
+        }
+
+        i2c_transaction_t* oldest = &i2c_async_slots[(i2c_async_head + I2C_ASYNC_QUEUE_SIZE - i2c_async_count) % I2C_ASYNC_QUEUE_SIZE];
+        chSysUnlock();
+        i2c_wait(oldest);
+    }
+}
+
+static i2c_status_t i2c_async_submit(uint8_t address, uint8_t regaddr, bool has_reg, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    uint8_t*           buffer;
+    i2c_transaction_t* txn = i2c_async_alloc(length + has_reg, &buffer);
+    if (!txn) {
+        return I2C_STATUS_ERROR;
+    }
+
+    if (has_reg) {
+        buffer[0] = regaddr;
+    }
+    memcpy(&buffer[has_reg], data, length);
+
+    txn->address   = address;
+    txn->tx_data   = buffer;
+    txn->tx_length = length + has_reg;
+    txn->rx_data   = NULL;
+    txn->rx_length = 0;
+    txn->timeout   = timeout;
+    txn->callback  = NULL;
+    i2c_queue(txn);
     return I2C_STATUS_SUCCESS;
 }
 
-i2c_status_t i2c_transmit(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout) {
-    i2c_address = address;
-    i2cStart(&I2C_DRIVER, &i2cconfig);
-    msg_t status = i2cMasterTransmitTimeout(&I2C_DRIVER, (i2c_address >> 1), data, length, 0, 0, TIME_MS2I(timeout));
-    return chibios_to_qmk(&status);
+i2c_status_t i2c_transmit_async(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout) { return i2c_async_submit(address, 0, false, data, length, timeout); }
+
+i2c_status_t i2c_writeReg_async(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout) { return i2c_async_submit(devaddr, regaddr, true, data, length, timeout); }
+
+i2c_status_t i2c_async_status(uint8_t address) {
+    uint8_t      device = (address >> 1) & 0x7F;
+    uint32_t     mask   = 1UL << (device % 32);
+    i2c_status_t result = I2C_STATUS_SUCCESS;
+
+    chSysLock();
+    if (i2c_async_timeouts[device / 32] & mask) {
+        result = I2C_STATUS_TIMEOUT;
+    } else if (i2c_async_errors[device / 32] & mask) {
+        result = I2C_STATUS_ERROR;
+    }
+    i2c_async_timeouts[device / 32] &= ~mask;
+    i2c_async_errors[device / 32] &= ~mask;
+    chSysUnlock();
+    return result;
 }
 
-i2c_status_t i2c_receive(uint8_t address, uint8_t* data, uint16_t length, uint16_t timeout) {
+// Runs a transaction from the calling thread's point of view, still queued
+// behind any async transfers so the bus sees everything in order.
+static i2c_status_t i2c_run(uint8_t address, const uint8_t* tx_data, uint16_t tx_length, uint8_t* rx_data, uint16_t rx_length, uint16_t timeout) {
+    i2c_transaction_t txn = {
+        .address   = address,
+        .tx_data   = tx_data,
+        .tx_length = tx_length,
+        .rx_data   = rx_data,
+        .rx_length = rx_length,
+        .timeout   = timeout,
+    };
+    i2c_submit(&txn);
+    return i2c_wait(&txn);
+}
+
+i2c_status_t i2c_start(uint8_t address) {
+    i2c_wait_idle();
     i2c_address = address;
     i2cStart(&I2C_DRIVER, &i2cconfig);
-    msg_t status = i2cMasterReceiveTimeout(&I2C_DRIVER, (i2c_address >> 1), data, length, TIME_MS2I(timeout));
-    return chibios_to_qmk(&status);
+    return I2C_STATUS_SUCCESS;
 }
 
-i2c_status_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout) {
-    i2c_address = devaddr;
-    i2cStart(&I2C_DRIVER, &i2cconfig);
+i2c_status_t i2c_transmit(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout) { return i2c_run(address, data, length, NULL, 0, timeout); }
 
+i2c_status_t i2c_receive(uint8_t address, uint8_t* data, uint16_t length, uint16_t timeout) { return i2c_run(address, NULL, 0, data, length, timeout); }
+
+i2c_status_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout) {
     uint8_t complete_packet[length + 1];
     for (uint8_t i = 0; i < length; i++) {
         complete_packet[i + 1] = data[i];
     }
     complete_packet[0] = regaddr;
 
-    msg_t status = i2cMasterTransmitTimeout(&I2C_DRIVER, (i2c_address >> 1), complete_packet, length + 1, 0, 0, TIME_MS2I(timeout));
-    return chibios_to_qmk(&status);
+    return i2c_run(devaddr, complete_packet, length + 1, NULL, 0, timeout);
 }
 
-i2c_status_t i2c_readReg(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout) {
-    i2c_address = devaddr;
-    i2cStart(&I2C_DRIVER, &i2cconfig);
-    msg_t status = i2cMasterTransmitTimeout(&I2C_DRIVER, (i2c_address >> 1), &regaddr, 1, data, length, TIME_MS2I(timeout));
-    return chibios_to_qmk(&status);
-}
+i2c_status_t i2c_readReg(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout) { return i2c_run(devaddr, &regaddr, 1, data, length, timeout); }
 
-void i2c_stop(void) { i2cStop(&I2C_DRIVER); }
+void i2c_stop(void) {
+    i2c_wait_idle();
+    i2cStop(&I2C_DRIVER);
+}
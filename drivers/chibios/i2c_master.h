@@ -98,11 +98,63 @@
 #    endif
 #endif
 
+// Transactions are run one at a time by a dedicated thread, so the bus
+// transfer no longer blocks the caller. The number of i2c_transmit_async()
+// transfers that can be waiting, and the space they have for copies of their data.
+#ifndef I2C_ASYNC_QUEUE_SIZE
+#    define I2C_ASYNC_QUEUE_SIZE 8
+#endif
+#ifndef I2C_ASYNC_BUFFER_SIZE
+#    define I2C_ASYNC_BUFFER_SIZE 256
+#endif
+#ifndef I2C_THREAD_STACK_SIZE
+#    define I2C_THREAD_STACK_SIZE 256
+#endif
+
 typedef int16_t i2c_status_t;
 
 #define I2C_STATUS_SUCCESS (0)
 #define I2C_STATUS_ERROR (-1)
 #define I2C_STATUS_TIMEOUT (-2)
+#define I2C_STATUS_PENDING (-3)
+
+typedef struct i2c_transaction_t i2c_transaction_t;
+
+// Runs on the I2C thread once the transaction has finished, before
+// i2c_done() reports it, so it may still use the transaction.
+typedef void (*i2c_callback_t)(i2c_transaction_t* txn, i2c_status_t status);
+
+// Writes tx_data and then, if rx_length is set, reads into rx_data. The
+// transaction and both buffers have to stay valid until it is done.
+struct i2c_transaction_t {
+    uint8_t        address;
+    const uint8_t* tx_data;
+    uint16_t       tx_length;
+    uint8_t*       rx_data;
+    uint16_t       rx_length;
+    uint16_t       timeout;
+    i2c_callback_t callback;
+    void*          user_data;
+
+    // Owned by the queue
+    volatile i2c_status_t status;
+    thread_reference_t    waiter;
+    uint16_t              buffer_end;
+    i2c_transaction_t*    next;
+};
+
+void         i2c_submit(i2c_transaction_t* txn);
+bool         i2c_done(const i2c_transaction_t* txn);
+i2c_status_t i2c_wait(i2c_transaction_t* txn);
+void         i2c_wait_idle(void);
+
+// Queue a write of a copy of data, returning as soon as it is queued. The
+// result of the transfer itself is reported by i2c_async_status().
+i2c_status_t i2c_transmit_async(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout);
+i2c_status_t i2c_writeReg_async(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout);
+// Returns, and clears, whether an async transfer to address failed since the
+// last call, so every device on the bus sees its own failures
+i2c_status_t i2c_async_status(uint8_t address);
 
 void         i2c_init(void);
 i2c_status_t i2c_start(uint8_t address);
@@ -17,9 +17,30 @@
 #include "spi_master.h"
 #include "quantum.h"
 #include "timer.h"
+#include <string.h>
 
-static pin_t     currentSlavePin = NO_PIN;
-static SPIConfig spiConfig       = {false, NULL, 0, 0, 0, 0};
+static pin_t        currentSlavePin = NO_PIN;
+static spi_device_t legacyDevice;
+
+// Copy of the configuration the peripheral was last started with
+static SPIConfig activeConfig;
+
+static THD_WORKING_AREA(waSPIThread, SPI_THREAD_STACK_SIZE);
+static thread_t*          spi_thread         = NULL;
+static thread_reference_t spi_thread_waiting = NULL;
+
+// Transfers waiting for the bus, linked through their next pointer
+static spi_transaction_t *spi_queue_head = NULL;
+static spi_transaction_t *spi_queue_tail = NULL;
+
+// Transfers for spi_transmit_async(), with their data copied into a ring
+// buffer. Transfers finish in order, so both are freed from the oldest end.
+static spi_transaction_t spi_async_slots[SPI_ASYNC_QUEUE_SIZE];
+static uint8_t           spi_async_buffer[SPI_ASYNC_BUFFER_SIZE];
+static uint8_t           spi_async_head      = 0;
+static uint8_t           spi_async_count     = 0;
+static uint16_t          spi_async_data_head = 0;
+static uint16_t          spi_async_data_tail = 0;
 
 __attribute__((weak)) void spi_init(void) {
     static bool is_initialised = false;
@@ -44,8 +65,8 @@ __attribute__((weak)) void spi_init(void) {
     }
 }
 
-bool spi_start(pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor) {
-    if (currentSlavePin != NO_PIN || slavePin == NO_PIN) {
+bool spi_device_init(spi_device_t *device, pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor) {
+    if (slavePin == NO_PIN) {
         return false;
     }
 
@@ -58,23 +79,23 @@ bool spi_start(pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor) {
         return false;
     }
 
-    spiConfig.cr1 = 0;
+    device->config.cr1 = 0;
 
     if (lsbFirst) {
-        spiConfig.cr1 |= SPI_CR1_LSBFIRST;
+        device->config.cr1 |= SPI_CR1_LSBFIRST;
     }
 
     switch (mode) {
         case 0:
             break;
         case 1:
-            spiConfig.cr1 |= SPI_CR1_CPHA;
+            device->config.cr1 |= SPI_CR1_CPHA;
             break;
         case 2:
-            spiConfig.cr1 |= SPI_CR1_CPOL;
+            device->config.cr1 |= SPI_CR1_CPOL;
             break;
         case 3:
-            spiConfig.cr1 |= SPI_CR1_CPHA | SPI_CR1_CPOL;
+            device->config.cr1 |= SPI_CR1_CPHA | SPI_CR1_CPOL;
             break;
     }
 
@@ -82,39 +103,202 @@ bool spi_start(pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor) {
         case 2:
             break;
         case 4:
-            spiConfig.cr1 |= SPI_CR1_BR_0;
+            device->config.cr1 |= SPI_CR1_BR_0;
             break;
         case 8:
-            spiConfig.cr1 |= SPI_CR1_BR_1;
+            device->config.cr1 |= SPI_CR1_BR_1;
             break;
         case 16:
-            spiConfig.cr1 |= SPI_CR1_BR_1 | SPI_CR1_BR_0;
+            device->config.cr1 |= SPI_CR1_BR_1 | SPI_CR1_BR_0;
             break;
         case 32:
-            spiConfig.cr1 |= SPI_CR1_BR_2;
+            device->config.cr1 |= SPI_CR1_BR_2;
             break;
         case 64:
-            spiConfig.cr1 |= SPI_CR1_BR_2 | SPI_CR1_BR_0;
+            device->config.cr1 |= SPI_CR1_BR_2 | SPI_CR1_BR_0;
             break;
         case 128:
-            spiConfig.cr1 |= SPI_CR1_BR_2 | SPI_CR1_BR_1;
+            device->config.cr1 |= SPI_CR1_BR_2 | SPI_CR1_BR_1;
             break;
         case 256:
-            spiConfig.cr1 |= SPI_CR1_BR_2 | SPI_CR1_BR_1 | SPI_CR1_BR_0;
+            device->config.cr1 |= SPI_CR1_BR_2 | SPI_CR1_BR_1 | SPI_CR1_BR_0;
             break;
     }
 
-    currentSlavePin  = slavePin;
-    spiConfig.ssport = PAL_PORT(slavePin);
-    spiConfig.sspad  = PAL_PAD(slavePin);
+    device->slave_pin     = slavePin;
+    device->config.ssport = PAL_PORT(slavePin);
+    device->config.sspad  = PAL_PAD(slavePin);
 
     setPinOutput(slavePin);
-    spiStart(&SPI_DRIVER, &spiConfig);
+    writePinHigh(slavePin);
+    return true;
+}
+
+// Only restarts the peripheral if it isn't already running with this
+// device's settings
+static void spi_configure(const spi_device_t *device) {
+    const SPIConfig *config = &device->config;
+    if (SPI_DRIVER.state != SPI_READY || SPI_DRIVER.config != &activeConfig || activeConfig.cr1 != config->cr1 || activeConfig.ssport != config->ssport || activeConfig.sspad != config->sspad) {
+        activeConfig = *config;
+        spiStart(&SPI_DRIVER, &activeConfig);
+    }
+}
+
+static THD_FUNCTION(SPIThread, arg) {
+    (void)arg;
+    chRegSetThreadName("spi");
+
+    while (true) {
+        chSysLock();
+        while (!spi_queue_head) {
+            chThdSuspendS(&spi_thread_waiting);
+        }
+        spi_transaction_t *txn = spi_queue_head;
+        spi_queue_head         = txn->next;
+        if (!spi_queue_head) {
+            spi_queue_tail = NULL;
+        }
+        chSysUnlock();
+
+        spi_status_t result = SPI_STATUS_SUCCESS;
+        if (txn->device) {
+            spi_configure(txn->device);
+            spiSelect(&SPI_DRIVER);
+            if (txn->tx_length > 0) {
+                spiSend(&SPI_DRIVER, txn->tx_length, txn->tx_data);
+            }
+            if (txn->rx_length > 0) {
+                spiReceive(&SPI_DRIVER, txn->rx_length, txn->rx_data);
+            }
+            spiUnselect(&SPI_DRIVER);
+        }
+
+        if (txn->callback) {
+            txn->callback(txn, result);
+        }
+
+        chSysLock();
+        if (txn->buffer_end) {
+            spi_async_data_tail = txn->buffer_end % SPI_ASYNC_BUFFER_SIZE;
+            spi_async_count--;
+        }
+        txn->status = result;
+        chThdResumeS(&txn->waiter, MSG_OK);
+        chSysUnlock();
+    }
+}
+
+static void spi_queue(spi_transaction_t *txn) {
+    if (!spi_thread) {
+        spi_thread = chThdCreateStatic(waSPIThread, sizeof(waSPIThread), NORMALPRIO + 1, SPIThread, NULL);
+    }
+
+    txn->status = SPI_STATUS_PENDING;
+    txn->waiter = NULL;
+    txn->next   = NULL;
+
+    chSysLock();
+    if (spi_queue_tail) {
+        spi_queue_tail->next = txn;
+    } else {
+        spi_queue_head = txn;
+    }
+    spi_queue_tail = txn;
+    chThdResumeS(&spi_thread_waiting, MSG_OK);
+    chSysUnlock();
+}
+
+void spi_submit(spi_transaction_t *txn) {
+    txn->buffer_end = 0;
+    spi_queue(txn);
+}
+
+bool spi_done(const spi_transaction_t *txn) { return txn->status != SPI_STATUS_PENDING; }
+
+spi_status_t spi_wait(spi_transaction_t *txn) {
+    chSysLock();
+    if (txn->status == SPI_STATUS_PENDING) {
+        chThdSuspendS(&txn->waiter);
+    }
+    chSysUnlock();
+    return txn->status;
+}
+
+void spi_wait_idle(void) {
+    // Queue an empty marker behind everything else and wait for it
+    spi_transaction_t marker = {.device = NULL};
+    if (spi_thread) {
+        spi_submit(&marker);
+        spi_wait(&marker);
+    }
+}
+
+spi_status_t spi_transmit_async(spi_device_t *device, const uint8_t *data, uint16_t length) {
+    if (length == 0 || length > SPI_ASYNC_BUFFER_SIZE) {
+        return SPI_STATUS_ERROR;
+    }
+
+    // Find room for the data, waiting for the oldest transfer to finish
+    // while there is none
+    while (true) {
+        chSysLock();
+        uint16_t start = spi_async_data_head;
+        bool     fits  = false;
+        if (spi_async_count == 0) {
+            start               = 0;
+            spi_async_data_tail = 0;
+            fits                = true;
+        } else if (spi_async_count < SPI_ASYNC_QUEUE_SIZE) {
+            if (spi_async_data_tail < spi_async_data_head) {
+                if (start + length > SPI_ASYNC_BUFFER_SIZE) {
+                    start = 0;
+                }
+                fits = start == 0 ? length <= spi_async_data_tail : true;
+            } else {
+                fits = start + length <= spi_async_data_tail;
+            }
+        }
+
+        if (fits) {
+            spi_transaction_t *txn = &spi_async_slots[spi_async_head];
+            spi_async_head         = (spi_async_head + 1) % SPI_ASYNC_QUEUE_SIZE;
+            spi_async_count++;
+            spi_async_data_head = (start + length) % SPI_ASYNC_BUFFER_SIZE;
+            chSysUnlock();
+
+            memcpy(&spi_async_buffer[start], data, length);
+            txn->device    = device;
+            txn->tx_data   = &spi_async_buffer[start];
+            txn->tx_length = length;
+            txn->rx_data   = NULL;
+            txn->rx_length = 0;
+            txn->callback  = NULL;
+            // buffer_end is never 0, it marks the transfer as owned by the queue
+            txn->buffer_end = start + length;
+            spi_queue(txn);
+            return SPI_STATUS_SUCCESS;
+        }
+
+        spi_transaction_t *oldest = &spi_async_slots[(spi_async_head + SPI_ASYNC_QUEUE_SIZE - spi_async_count) % SPI_ASYNC_QUEUE_SIZE];
+        chSysUnlock();
+        spi_wait(oldest);
+    }
+}
+
+bool spi_start(pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor) {
+    if (currentSlavePin != NO_PIN || !spi_device_init(&legacyDevice, slavePin, lsbFirst, mode, divisor)) {
+        return false;
+    }
+
+    // Queued transfers have to finish before the bus is used directly
+    spi_wait_idle();
+
+    currentSlavePin = slavePin;
+    spi_configure(&legacyDevice);
     spiSelect(&SPI_DRIVER);
 
     return true;
 }
-
 spi_status_t spi_write(uint8_t data) {
     uint8_t rxData;
     spiExchange(&SPI_DRIVER, 1, &data, &rxData);
@@ -141,8 +325,9 @@ spi_status_t spi_receive(uint8_t *data, uint16_t length) {
 
 void spi_stop(void) {
     if (currentSlavePin != NO_PIN) {
+        // The peripheral is left running, so the next transfer with the same
+        // settings doesn't have to start it again
         spiUnselect(&SPI_DRIVER);
-        spiStop(&SPI_DRIVER);
         currentSlavePin = NO_PIN;
     }
 }
@@ -48,15 +48,61 @@
 #    define SPI_MISO_PAL_MODE 5
 #endif
 
+// Transfers are run one at a time by a dedicated thread, so the bus time
+// overlaps with the caller. The number of spi_transmit_async() transfers that
+// can be waiting, and the space they have for copies of their data.
+#ifndef SPI_ASYNC_QUEUE_SIZE
+#    define SPI_ASYNC_QUEUE_SIZE 8
+#endif
+#ifndef SPI_ASYNC_BUFFER_SIZE
+#    define SPI_ASYNC_BUFFER_SIZE 256
+#endif
+#ifndef SPI_THREAD_STACK_SIZE
+#    define SPI_THREAD_STACK_SIZE 256
+#endif
+
 typedef int16_t spi_status_t;
 
 #define SPI_STATUS_SUCCESS (0)
 #define SPI_STATUS_ERROR (-1)
 #define SPI_STATUS_TIMEOUT (-2)
+#define SPI_STATUS_PENDING (-3)
 
 #define SPI_TIMEOUT_IMMEDIATE (0)
 #define SPI_TIMEOUT_INFINITE (0xFFFF)
 
+// A device on the bus, with its peripheral configuration worked out once.
+// The peripheral is only reconfigured when switching between devices.
+typedef struct {
+    pin_t     slave_pin;
+    SPIConfig config;
+} spi_device_t;
+
+typedef struct spi_transaction_t spi_transaction_t;
+
+// Runs on the SPI thread once the transfer has finished, before spi_done()
+// reports it, so it may still use the transaction.
+typedef void (*spi_callback_t)(spi_transaction_t *txn, spi_status_t status);
+
+// Selects the device, sends tx_data and then, if rx_length is set, reads
+// into rx_data. The transaction and both buffers have to stay valid until it
+// is done.
+struct spi_transaction_t {
+    spi_device_t * device;
+    const uint8_t *tx_data;
+    uint16_t       tx_length;
+    uint8_t *      rx_data;
+    uint16_t       rx_length;
+    spi_callback_t callback;
+    void *         user_data;
+
+    // Owned by the queue
+    volatile spi_status_t status;
+    thread_reference_t    waiter;
+    uint16_t              buffer_end;
+    spi_transaction_t *   next;
+};
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -73,6 +119,16 @@ spi_status_t spi_transmit(const uint8_t *data, uint16_t length);
 spi_status_t spi_receive(uint8_t *data, uint16_t length);
 
 void spi_stop(void);
+
+bool spi_device_init(spi_device_t *device, pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor);
+
+void         spi_submit(spi_transaction_t *txn);
+bool         spi_done(const spi_transaction_t *txn);
+spi_status_t spi_wait(spi_transaction_t *txn);
+void         spi_wait_idle(void);
+
+// Queue a write of a copy of data, returning as soon as it is queued
+spi_status_t spi_transmit_async(spi_device_t *device, const uint8_t *data, uint16_t length);
 #ifdef __cplusplus
 }
 #endif
@@ -76,6 +76,27 @@ void sendByte(uint8_t byte) {
 
 void ws2812_init(void) { palSetLineMode(RGB_DI_PIN, WS2812_OUTPUT_MODE); }
 
+static inline void ws2812_send_led(LED_TYPE color) {
+    // WS2812 protocol dictates grb order
+#if (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_GRB)
+    sendByte(color.g);
+    sendByte(color.r);
+    sendByte(color.b);
+#elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_RGB)
+    sendByte(color.r);
+    sendByte(color.g);
+    sendByte(color.b);
+#elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_BGR)
+    sendByte(color.b);
+    sendByte(color.g);
+    sendByte(color.r);
+#endif
+
+#ifdef RGBW
+    sendByte(color.w);
+#endif
+}
+
 // Setleds for standard RGB
 void ws2812_setleds(LED_TYPE *ledarray, uint16_t leds) {
     static bool s_init = false;
@@ -88,27 +109,31 @@ void ws2812_setleds(LED_TYPE *ledarray, uint16_t leds) {
     chSysLock();
 
     for (uint8_t i = 0; i < leds; i++) {
-        // WS2812 protocol dictates grb order
-#if (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_GRB)
-        sendByte(ledarray[i].g);
-        sendByte(ledarray[i].r);
-        sendByte(ledarray[i].b);
-#elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_RGB)
-        sendByte(ledarray[i].r);
-        sendByte(ledarray[i].g);
-        sendByte(ledarray[i].b);
-#elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_BGR)
-        sendByte(ledarray[i].b);
-        sendByte(ledarray[i].g);
-        sendByte(ledarray[i].r);
-#endif
+        ws2812_send_led(ledarray[i]);
+    }
 
-#ifdef RGBW
-        sendByte(ledarray[i].w);
-#endif
+    wait_ns(RES);
+
+    chSysUnlock();
+}
+
+void ws2812_setleds_mapped(LED_TYPE *ledarray, const uint8_t *led_map, uint16_t leds) {
+    static bool s_init = false;
+    if (!s_init) {
+        ws2812_init();
+        s_init = true;
+    }
+
+    // this code is very time dependent, so we need to disable interrupts
+    chSysLock();
+
+    for (uint16_t i = 0; i < leds; i++) {
+        ws2812_send_led(ws2812_mapped_led(ledarray, led_map, i));
     }
 
     wait_ns(RES);
 
     chSysUnlock();
 }
+
+bool ws2812_flush_complete(void) { return true; }
@@ -1,6 +1,7 @@
 #include "ws2812.h"
 #include "quantum.h"
 #include <hal.h>
+#include <string.h>
 
 /* Adapted from https://github.com/joewa/WS2812-LED-Driver_ChibiOS/ */
 
@@ -228,22 +229,81 @@
 #    define WS2812_BLUE_BIT(led, bit) WS2812_BIT((led), 0, (bit))
 #endif
 
+/**
+ * @brief   Number of frame buffers
+ *
+ * With a single buffer, the DMA stream loops over it forever and new colors are written while it is being sent.
+ * With two, each frame is sent once from one buffer while the next one is encoded into the other.
+ */
+#ifdef WS2812_PWM_DOUBLE_BUFFER
+#    define WS2812_FRAME_BUFFER_N 2
+#else
+#    define WS2812_FRAME_BUFFER_N 1
+#endif
+
 /* --- PRIVATE VARIABLES ---------------------------------------------------- */
 
-static uint32_t ws2812_frame_buffer[WS2812_BIT_N + 1]; /**< Buffer for a frame */
+static uint32_t         ws2812_frame_buffer[WS2812_FRAME_BUFFER_N][WS2812_BIT_N + 1]; /**< Buffers for a frame */
+static volatile uint8_t ws2812_back_buffer = 0;                                       /**< The buffer new colors are written to */
 
-/* --- PUBLIC FUNCTIONS ----------------------------------------------------- */
-/*
- * Gedanke: Double-buffer type transactions: double buffer transfers using two memory pointers for
-the memory (while the DMA is reading/writing from/to a buffer, the application can
-write/read to/from the other buffer).
+#ifdef WS2812_PWM_DOUBLE_BUFFER
+static uint8_t       ws2812_last_encoded = 0;     /**< The buffer holding the most recently written frame */
+static volatile bool ws2812_send_pending = false; /**< The back buffer is waiting for the current frame to finish */
+static volatile bool ws2812_busy         = false; /**< A frame is being sent */
+#else
+static volatile uint8_t ws2812_cycles_left = 0; /**< Complete DMA cycles until the last written colors have been sent in full */
+#endif
+
+/* --- PRIVATE FUNCTIONS ---------------------------------------------------- */
+
+#ifdef WS2812_PWM_DOUBLE_BUFFER
+/**
+ * @brief   Send the back buffer and swap buffers
+ *
+ * @note    Must be called with the system locked
  */
+static void ws2812_start_frame(void) {
+    dmaStreamDisable(WS2812_DMA_STREAM);
+    dmaStreamSetMemory0(WS2812_DMA_STREAM, ws2812_frame_buffer[ws2812_back_buffer]);
+    dmaStreamSetTransactionSize(WS2812_DMA_STREAM, WS2812_BIT_N);
+    dmaStreamEnable(WS2812_DMA_STREAM);
+
+    ws2812_back_buffer ^= 1;
+    ws2812_send_pending = false;
+    ws2812_busy         = true;
+}
+#endif
+
+/**
+ * @brief   DMA transfer complete handler
+ *
+ * Chains a pending frame when double buffered, otherwise counts down the cycles left before a flush is complete.
+ */
+static void ws2812_dma_cb(void* param, uint32_t flags) {
+    if (!(flags & STM32_DMA_ISR_TCIF)) return;
+
+    osalSysLockFromISR();
+#ifdef WS2812_PWM_DOUBLE_BUFFER
+    if (ws2812_send_pending) {
+        ws2812_start_frame();
+    } else {
+        ws2812_busy = false;
+    }
+#else
+    if (ws2812_cycles_left) ws2812_cycles_left--;
+#endif
+    osalSysUnlockFromISR();
+}
+
+/* --- PUBLIC FUNCTIONS ----------------------------------------------------- */
 
 void ws2812_init(void) {
-    // Initialize led frame buffer
+    // Initialize led frame buffers
     uint32_t i;
-    for (i = 0; i < WS2812_COLOR_BIT_N; i++) ws2812_frame_buffer[i] = WS2812_DUTYCYCLE_0;      // All color bits are zero duty cycle
-    for (i = 0; i < WS2812_RESET_BIT_N; i++) ws2812_frame_buffer[i + WS2812_COLOR_BIT_N] = 0;  // All reset bits are zero
+    for (uint8_t buffer = 0; buffer < WS2812_FRAME_BUFFER_N; buffer++) {
+        for (i = 0; i < WS2812_COLOR_BIT_N; i++) ws2812_frame_buffer[buffer][i] = WS2812_DUTYCYCLE_0;      // All color bits are zero duty cycle
+        for (i = 0; i < WS2812_RESET_BIT_N; i++) ws2812_frame_buffer[buffer][i + WS2812_COLOR_BIT_N] = 0;  // All reset bits are zero
+    }
 
     palSetLineMode(RGB_DI_PIN, WS2812_OUTPUT_MODE);
 
@@ -265,11 +325,16 @@ void ws2812_init(void) {
 
     // Configure DMA
     // dmaInit(); // Joe added this
-    dmaStreamAlloc(WS2812_DMA_STREAM - STM32_DMA_STREAM(0), 10, NULL, NULL);
+    dmaStreamAlloc(WS2812_DMA_STREAM - STM32_DMA_STREAM(0), 10, ws2812_dma_cb, NULL);
     dmaStreamSetPeripheral(WS2812_DMA_STREAM, &(WS2812_PWM_DRIVER.tim->CCR[WS2812_PWM_CHANNEL - 1]));  // Ziel ist der An-Zeit im Cap-Comp-Register
-    dmaStreamSetMemory0(WS2812_DMA_STREAM, ws2812_frame_buffer);
+    dmaStreamSetMemory0(WS2812_DMA_STREAM, ws2812_frame_buffer[0]);
     dmaStreamSetTransactionSize(WS2812_DMA_STREAM, WS2812_BIT_N);
-    dmaStreamSetMode(WS2812_DMA_STREAM, STM32_DMA_CR_CHSEL(WS2812_DMA_CHANNEL) | STM32_DMA_CR_DIR_M2P | STM32_DMA_CR_PSIZE_WORD | STM32_DMA_CR_MSIZE_WORD | STM32_DMA_CR_MINC | STM32_DMA_CR_CIRC | STM32_DMA_CR_PL(3));
+#ifdef WS2812_PWM_DOUBLE_BUFFER
+    // One shot per frame, restarted by ws2812_start_frame()
+    dmaStreamSetMode(WS2812_DMA_STREAM, STM32_DMA_CR_CHSEL(WS2812_DMA_CHANNEL) | STM32_DMA_CR_DIR_M2P | STM32_DMA_CR_PSIZE_WORD | STM32_DMA_CR_MSIZE_WORD | STM32_DMA_CR_MINC | STM32_DMA_CR_TCIE | STM32_DMA_CR_PL(3));
+#else
+    dmaStreamSetMode(WS2812_DMA_STREAM, STM32_DMA_CR_CHSEL(WS2812_DMA_CHANNEL) | STM32_DMA_CR_DIR_M2P | STM32_DMA_CR_PSIZE_WORD | STM32_DMA_CR_MSIZE_WORD | STM32_DMA_CR_MINC | STM32_DMA_CR_CIRC | STM32_DMA_CR_TCIE | STM32_DMA_CR_PL(3));
+#endif
     // M2P: Memory 2 Periph; PL: Priority Level
 
 #if (STM32_DMA_SUPPORTS_DMAMUX == TRUE)
@@ -277,8 +342,10 @@ void ws2812_init(void) {
     dmaSetRequestSource(WS2812_DMA_STREAM, WS2812_DMAMUX_ID);
 #endif
 
+#ifndef WS2812_PWM_DOUBLE_BUFFER
     // Start DMA
     dmaStreamEnable(WS2812_DMA_STREAM);
+#endif
 
     // Configure PWM
     // NOTE: It's required that preload be enabled on the timer channel CCR register. This is currently enabled in the
@@ -289,23 +356,65 @@ void ws2812_init(void) {
 }
 
 void ws2812_write_led(uint16_t led_number, uint8_t r, uint8_t g, uint8_t b) {
+    uint32_t* frame_buffer = ws2812_frame_buffer[ws2812_back_buffer];
+
     // Write color to frame buffer
     for (uint8_t bit = 0; bit < 8; bit++) {
-        ws2812_frame_buffer[WS2812_RED_BIT(led_number, bit)]   = ((r >> bit) & 0x01) ? WS2812_DUTYCYCLE_1 : WS2812_DUTYCYCLE_0;
-        ws2812_frame_buffer[WS2812_GREEN_BIT(led_number, bit)] = ((g >> bit) & 0x01) ? WS2812_DUTYCYCLE_1 : WS2812_DUTYCYCLE_0;
-        ws2812_frame_buffer[WS2812_BLUE_BIT(led_number, bit)]  = ((b >> bit) & 0x01) ? WS2812_DUTYCYCLE_1 : WS2812_DUTYCYCLE_0;
+        frame_buffer[WS2812_RED_BIT(led_number, bit)]   = ((r >> bit) & 0x01) ? WS2812_DUTYCYCLE_1 : WS2812_DUTYCYCLE_0;
+        frame_buffer[WS2812_GREEN_BIT(led_number, bit)] = ((g >> bit) & 0x01) ? WS2812_DUTYCYCLE_1 : WS2812_DUTYCYCLE_0;
+        frame_buffer[WS2812_BLUE_BIT(led_number, bit)]  = ((b >> bit) & 0x01) ? WS2812_DUTYCYCLE_1 : WS2812_DUTYCYCLE_0;
     }
 }
 
 // Setleds for standard RGB
-void ws2812_setleds(LED_TYPE* ledarray, uint16_t leds) {
+void ws2812_setleds(LED_TYPE* ledarray, uint16_t leds) { ws2812_setleds_mapped(ledarray, NULL, leds); }
+
+void ws2812_setleds_mapped(LED_TYPE* ledarray, const uint8_t* led_map, uint16_t leds) {
     static bool s_init = false;
     if (!s_init) {
         ws2812_init();
         s_init = true;
     }
 
+#ifdef WS2812_PWM_DOUBLE_BUFFER
+    // Keep the DMA handler from sending the back buffer while it's being written.
+    // A frame that was still pending is simply replaced.
+    ws2812_send_pending = false;
+#endif
+
     for (uint16_t i = 0; i < leds; i++) {
-        ws2812_write_led(i, ledarray[i].r, ledarray[i].g, ledarray[i].b);
+        LED_TYPE color = ws2812_mapped_led(ledarray, led_map, i);
+        ws2812_write_led(i, color.r, color.g, color.b);
+    }
+
+#ifdef WS2812_PWM_DOUBLE_BUFFER
+    // LEDs past the end of a partial update keep their previous colors
+    if (leds < RGBLED_NUM && ws2812_last_encoded != ws2812_back_buffer) {
+        memcpy(&ws2812_frame_buffer[ws2812_back_buffer][24 * leds], &ws2812_frame_buffer[ws2812_last_encoded][24 * leds], sizeof(uint32_t) * 24 * (RGBLED_NUM - leds));
+    }
+    ws2812_last_encoded = ws2812_back_buffer;
+
+    // If the previous frame is still going out, this one is sent from the DMA handler
+    osalSysLock();
+    if (ws2812_busy) {
+        ws2812_send_pending = true;
+    } else {
+        ws2812_start_frame();
     }
+    osalSysUnlock();
+#else
+    // The frame being sent may have started before these colors were written,
+    // so they're only guaranteed to be out after the one following it
+    osalSysLock();
+    ws2812_cycles_left = 2;
+    osalSysUnlock();
+#endif
+}
+
+bool ws2812_flush_complete(void) {
+#ifdef WS2812_PWM_DOUBLE_BUFFER
+    return !ws2812_send_pending && !ws2812_busy;
+#else
+    return !ws2812_cycles_left;
+#endif
 }
@@ -1,5 +1,6 @@
 #include "quantum.h"
 #include "ws2812.h"
+#include <string.h>
 
 /* Adapted from https://github.com/gamazeps/ws2812b-chibios-SPIDMA/ */
 
@@ -69,8 +70,25 @@
 #define DATA_SIZE (BYTES_FOR_LED * RGBLED_NUM)
 #define RESET_SIZE (1000 * WS2812_TRST_US / (2 * 1250))
 #define PREAMBLE_SIZE 4
+#define TXBUF_SIZE (PREAMBLE_SIZE + DATA_SIZE + RESET_SIZE)
 
-static uint8_t txbuf[PREAMBLE_SIZE + DATA_SIZE + RESET_SIZE] = {0};
+// Outside of circular and sync modes, frames are encoded into one buffer
+// while the other one is still being sent
+#if defined(WS2812_SPI_USE_CIRCULAR_BUFFER) || defined(WS2812_SPI_SYNC)
+#    define TXBUF_COUNT 1
+#else
+#    define TXBUF_COUNT 2
+#endif
+
+static uint8_t txbuf[TXBUF_COUNT][TXBUF_SIZE] = {{0}};
+// The buffer ws2812_setleds() encodes into
+static volatile uint8_t back_buffer = 0;
+#if TXBUF_COUNT > 1
+// Whether the back buffer holds a frame waiting for the current one to finish
+static volatile bool send_pending = false;
+// The buffer holding the most recently encoded frame
+static uint8_t last_encoded = 0;
+#endif
 
 /*
  * As the trick here is to use the SPI to send a huge pattern of 0 and 1 to
@@ -91,7 +109,7 @@ static uint8_t get_protocol_eq(uint8_t data, int pos) {
 }
 
 static void set_led_color_rgb(LED_TYPE color, int pos) {
-    uint8_t* tx_start = &txbuf[PREAMBLE_SIZE];
+    uint8_t* tx_start = &txbuf[back_buffer][PREAMBLE_SIZE];
 
 #if (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_GRB)
     for (int j = 0; j < 4; j++) tx_start[BYTES_FOR_LED * pos + j] = get_protocol_eq(color.g, j);
@@ -108,38 +126,86 @@ static void set_led_color_rgb(LED_TYPE color, int pos) {
 #endif
 }
 
+#if TXBUF_COUNT > 1
+// Must be called with the system locked
+static void ws2812_start_send(void) {
+    spiStartSendI(&WS2812_SPI, TXBUF_SIZE, txbuf[back_buffer]);
+    back_buffer ^= 1;
+    send_pending = false;
+}
+
+// Chains the pending frame, if any, as soon as the previous one is out
+static void ws2812_spi_end_cb(SPIDriver* spip) {
+    osalSysLockFromISR();
+    if (send_pending) {
+        ws2812_start_send();
+    }
+    osalSysUnlockFromISR();
+}
+#    define WS2812_SPI_END_CB ws2812_spi_end_cb
+#else
+#    define WS2812_SPI_END_CB NULL
+#endif
+
 void ws2812_init(void) {
     palSetLineMode(RGB_DI_PIN, WS2812_OUTPUT_MODE);
 
     // TODO: more dynamic baudrate
-    static const SPIConfig spicfg = {WS2812_SPI_BUFFER_MODE, NULL, PAL_PORT(RGB_DI_PIN), PAL_PAD(RGB_DI_PIN), WS2812_SPI_DIVISOR};
+    static const SPIConfig spicfg = {WS2812_SPI_BUFFER_MODE, WS2812_SPI_END_CB, PAL_PORT(RGB_DI_PIN), PAL_PAD(RGB_DI_PIN), WS2812_SPI_DIVISOR};
 
     spiAcquireBus(&WS2812_SPI);     /* Acquire ownership of the bus.    */
     spiStart(&WS2812_SPI, &spicfg); /* Setup transfer parameters.       */
     spiSelect(&WS2812_SPI);         /* Slave Select assertion.          */
 #ifdef WS2812_SPI_USE_CIRCULAR_BUFFER
-    spiStartSend(&WS2812_SPI, sizeof(txbuf) / sizeof(txbuf[0]), txbuf);
+    spiStartSend(&WS2812_SPI, TXBUF_SIZE, txbuf[0]);
 #endif
 }
 
-void ws2812_setleds(LED_TYPE* ledarray, uint16_t leds) {
+void ws2812_setleds(LED_TYPE* ledarray, uint16_t leds) { ws2812_setleds_mapped(ledarray, NULL, leds); }
+
+void ws2812_setleds_mapped(LED_TYPE* ledarray, const uint8_t* led_map, uint16_t leds) {
     static bool s_init = false;
     if (!s_init) {
         ws2812_init();
         s_init = true;
     }
 
+#if TXBUF_COUNT > 1
+    // Keep the end callback from sending the back buffer while it's being
+    // encoded. A frame that was still pending is simply replaced.
+    send_pending = false;
+#endif
+
     for (uint8_t i = 0; i < leds; i++) {
-        set_led_color_rgb(ledarray[i], i);
+        set_led_color_rgb(ws2812_mapped_led(ledarray, led_map, i), i);
     }
 
-    // Send async - each led takes ~0.03ms, 50 leds ~1.5ms, animations flushing faster than send will cause issues.
-    // Instead spiSend can be used to send synchronously (or the thread logic can be added back).
-#ifndef WS2812_SPI_USE_CIRCULAR_BUFFER
-#    ifdef WS2812_SPI_SYNC
-    spiSend(&WS2812_SPI, sizeof(txbuf) / sizeof(txbuf[0]), txbuf);
-#    else
-    spiStartSend(&WS2812_SPI, sizeof(txbuf) / sizeof(txbuf[0]), txbuf);
-#    endif
+#if TXBUF_COUNT > 1
+    // LEDs past the end of a partial update keep their previous colors
+    if (leds < RGBLED_NUM && last_encoded != back_buffer) {
+        memcpy(&txbuf[back_buffer][PREAMBLE_SIZE + BYTES_FOR_LED * leds], &txbuf[last_encoded][PREAMBLE_SIZE + BYTES_FOR_LED * leds], BYTES_FOR_LED * (RGBLED_NUM - leds));
+    }
+    last_encoded = back_buffer;
+
+    // Send async - each led takes ~0.03ms, 50 leds ~1.5ms. If the previous
+    // frame is still going out, this one is sent from its end callback.
+    osalSysLock();
+    if (WS2812_SPI.state == SPI_READY) {
+        ws2812_start_send();
+    } else {
+        send_pending = true;
+    }
+    osalSysUnlock();
+#elif defined(WS2812_SPI_SYNC)
+    spiSend(&WS2812_SPI, TXBUF_SIZE, txbuf[0]);
+#endif
+}
+
+bool ws2812_flush_complete(void) {
+#if TXBUF_COUNT > 1
+    return !send_pending && WS2812_SPI.state != SPI_ACTIVE;
+#else
+    // Sync sends return once done, and circular mode keeps resending
+    return true;
 #endif
 }
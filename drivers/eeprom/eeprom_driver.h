@@ -20,3 +20,7 @@
 
 void eeprom_driver_init(void);
 void eeprom_driver_erase(void);
+
+// Drivers that hold back writes send them out here
+void eeprom_driver_flush(void);
+void eeprom_driver_task(void);
@@ -15,6 +15,7 @@
  */
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
 
 /*
@@ -30,15 +31,16 @@
     there is nothing to override during linkage.
 */
 
-#include "wait.h"
+#include "timer.h"
 #include "i2c_master.h"
 #include "eeprom.h"
+#include "eeprom_driver.h"
+#include "eeprom_page_cache.h"
 #include "eeprom_i2c.h"
 
 // #define DEBUG_EEPROM_OUTPUT
 
 #if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
-#    include "timer.h"
 #    include "debug.h"
 #endif  // DEBUG_EEPROM_OUTPUT
 
@@ -50,6 +52,27 @@ static inline void fill_target_address(uint8_t *buffer, const void *addr) {
     }
 }
 
+static bool     write_pending = false;
+static uint8_t  write_device;
+static uint32_t write_timer;
+
+// Acknowledge polling: the EEPROM doesn't ack its address until the last page
+// write has finished, so keep addressing it instead of waiting the full
+// EXTERNAL_EEPROM_WRITE_TIME.
+static void i2c_eeprom_wait_ready(void) {
+    if (!write_pending) {
+        return;
+    }
+
+    uint8_t address[EXTERNAL_EEPROM_ADDRESS_SIZE] = {0};
+    while (i2c_transmit(write_device, address, EXTERNAL_EEPROM_ADDRESS_SIZE, 100) != I2C_STATUS_SUCCESS) {
+        if (timer_elapsed32(write_timer) > EXTERNAL_EEPROM_WRITE_TIMEOUT) {
+            break;
+        }
+    }
+    write_pending = false;
+}
+
 void eeprom_driver_init(void) { i2c_init(); }
 
 void eeprom_driver_erase(void) {
@@ -62,58 +85,50 @@ void eeprom_driver_erase(void) {
     for (uint32_t addr = 0; addr < EXTERNAL_EEPROM_BYTE_COUNT; addr += EXTERNAL_EEPROM_PAGE_SIZE) {
         eeprom_write_block(buf, (void *)(uintptr_t)addr, EXTERNAL_EEPROM_PAGE_SIZE);
     }
+    eeprom_driver_flush();
 
 #if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
     dprintf("EEPROM erase took %ldms to complete\n", ((long)(timer_read32() - start)));
 #endif
 }
 
-void eeprom_read_block(void *buf, const void *addr, size_t len) {
+void eeprom_cache_bus_read(uintptr_t addr, uint8_t *buf, size_t len) {
     uint8_t complete_packet[EXTERNAL_EEPROM_ADDRESS_SIZE];
-    fill_target_address(complete_packet, addr);
+    fill_target_address(complete_packet, (const void *)addr);
 
-    i2c_transmit(EXTERNAL_EEPROM_I2C_ADDRESS((uintptr_t)addr), complete_packet, EXTERNAL_EEPROM_ADDRESS_SIZE, 100);
-    i2c_receive(EXTERNAL_EEPROM_I2C_ADDRESS((uintptr_t)addr), buf, len, 100);
+    i2c_eeprom_wait_ready();
+    i2c_transmit(EXTERNAL_EEPROM_I2C_ADDRESS(addr), complete_packet, EXTERNAL_EEPROM_ADDRESS_SIZE, 100);
+    i2c_receive(EXTERNAL_EEPROM_I2C_ADDRESS(addr), buf, len, 100);
 
 #if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
     dprintf("[EEPROM R] 0x%04X: ", ((int)addr));
     for (size_t i = 0; i < len; ++i) {
-        dprintf(" %02X", (int)(((uint8_t *)buf)[i]));
+        dprintf(" %02X", (int)(buf[i]));
     }
     dprintf("\n");
 #endif  // DEBUG_EEPROM_OUTPUT
 }
 
-void eeprom_write_block(const void *buf, void *addr, size_t len) {
-    uint8_t   complete_packet[EXTERNAL_EEPROM_ADDRESS_SIZE + EXTERNAL_EEPROM_PAGE_SIZE];
-    uint8_t * read_buf    = (uint8_t *)buf;
-    uintptr_t target_addr = (uintptr_t)addr;
+void eeprom_cache_bus_write(uintptr_t addr, const uint8_t *buf, size_t len) {
+    uint8_t complete_packet[EXTERNAL_EEPROM_ADDRESS_SIZE + EXTERNAL_EEPROM_PAGE_SIZE];
 
-    while (len > 0) {
-        uintptr_t page_offset  = target_addr % EXTERNAL_EEPROM_PAGE_SIZE;
-        int       write_length = EXTERNAL_EEPROM_PAGE_SIZE - page_offset;
-        if (write_length > len) {
-            write_length = len;
-        }
-
-        fill_target_address(complete_packet, (const void *)target_addr);
-        for (uint8_t i = 0; i < write_length; i++) {
-            complete_packet[EXTERNAL_EEPROM_ADDRESS_SIZE + i] = read_buf[i];
-        }
+    fill_target_address(complete_packet, (const void *)addr);
+    memcpy(&complete_packet[EXTERNAL_EEPROM_ADDRESS_SIZE], buf, len);
 
 #if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
-        dprintf("[EEPROM W] 0x%04X: ", ((int)target_addr));
-        for (uint8_t i = 0; i < write_length; i++) {
-            dprintf(" %02X", (int)(read_buf[i]));
-        }
-        dprintf("\n");
+    dprintf("[EEPROM W] 0x%04X: ", ((int)addr));
+    for (size_t i = 0; i < len; i++) {
+        dprintf(" %02X", (int)(buf[i]));
+    }
+    dprintf("\n");
 #endif  // DEBUG_EEPROM_OUTPUT
 
-        i2c_transmit(EXTERNAL_EEPROM_I2C_ADDRESS((uintptr_t)addr), complete_packet, EXTERNAL_EEPROM_ADDRESS_SIZE + write_length, 100);
-        wait_ms(EXTERNAL_EEPROM_WRITE_TIME);
+    i2c_eeprom_wait_ready();
+    i2c_transmit(EXTERNAL_EEPROM_I2C_ADDRESS(addr), complete_packet, EXTERNAL_EEPROM_ADDRESS_SIZE + len, 100);
 
-        read_buf += write_length;
-        target_addr += write_length;
-        len -= write_length;
-    }
+#if EXTERNAL_EEPROM_WRITE_TIME > 0
+    write_pending = true;
+    write_device  = EXTERNAL_EEPROM_I2C_ADDRESS(addr);
+    write_timer   = timer_read32();
+#endif
 }
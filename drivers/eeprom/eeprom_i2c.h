@@ -118,3 +118,12 @@
 #ifndef EXTERNAL_EEPROM_WRITE_TIME
 #    define EXTERNAL_EEPROM_WRITE_TIME 5
 #endif
+
+/*
+    How long to keep polling for the EEPROM to acknowledge its address after a
+    page write, in milliseconds. It normally answers well within
+    EXTERNAL_EEPROM_WRITE_TIME.
+*/
+#ifndef EXTERNAL_EEPROM_WRITE_TIMEOUT
+#    define EXTERNAL_EEPROM_WRITE_TIMEOUT (EXTERNAL_EEPROM_WRITE_TIME * 2)
+#endif
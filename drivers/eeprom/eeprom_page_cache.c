@@ -0,0 +1,157 @@
+/* Copyright 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "timer.h"
+#include "eeprom.h"
+#include "eeprom_driver.h"
+#include "eeprom_page_cache.h"
+
+#if defined(EEPROM_I2C)
+#    include "eeprom_i2c.h"
+#elif defined(EEPROM_SPI)
+#    include "eeprom_spi.h"
+#endif
+
+#define CACHE_PAGE_EMPTY UINTPTR_MAX
+
+typedef struct {
+    uintptr_t base;
+    uint32_t  last_used;
+    uint16_t  dirty_start;
+    uint16_t  dirty_end;
+    uint8_t   data[EXTERNAL_EEPROM_PAGE_SIZE];
+} eeprom_cache_page_t;
+
+static eeprom_cache_page_t cache_pages[EXTERNAL_EEPROM_CACHE_PAGES];
+static bool                cache_ready = false;
+static uint32_t            cache_uses  = 0;
+static bool                cache_dirty = false;
+static uint32_t            cache_dirty_timer;
+
+static void cache_write_back(eeprom_cache_page_t *page) {
+    if (page->dirty_start < page->dirty_end) {
+        eeprom_cache_bus_write(page->base + page->dirty_start, &page->data[page->dirty_start], page->dirty_end - page->dirty_start);
+        page->dirty_start = EXTERNAL_EEPROM_PAGE_SIZE;
+        page->dirty_end   = 0;
+    }
+}
+
+void eeprom_cache_invalidate(void) {
+    for (uint8_t i = 0; i < EXTERNAL_EEPROM_CACHE_PAGES; i++) {
+        cache_pages[i].base        = CACHE_PAGE_EMPTY;
+        cache_pages[i].dirty_start = EXTERNAL_EEPROM_PAGE_SIZE;
+        cache_pages[i].dirty_end   = 0;
+    }
+    cache_dirty = false;
+    cache_ready = true;
+}
+
+// Returns the cached copy of the page at base, evicting the least recently
+// used page if needed. The page is only read from the bus when load is set.
+static eeprom_cache_page_t *cache_get(uintptr_t base, bool load) {
+    if (!cache_ready) {
+        eeprom_cache_invalidate();
+    }
+
+    eeprom_cache_page_t *page = &cache_pages[0];
+    for (uint8_t i = 0; i < EXTERNAL_EEPROM_CACHE_PAGES; i++) {
+        if (cache_pages[i].base == base) {
+            page = &cache_pages[i];
+            page->last_used = ++cache_uses;
+            return page;
+        }
+        if (cache_pages[i].last_used < page->last_used) {
+            page = &cache_pages[i];
+        }
+    }
+
+    cache_write_back(page);
+    page->base      = base;
+    page->last_used = ++cache_uses;
+    if (load) {
+        eeprom_cache_bus_read(base, page->data, EXTERNAL_EEPROM_PAGE_SIZE);
+    }
+    return page;
+}
+
+void eeprom_read_block(void *buf, const void *addr, size_t len) {
+    uint8_t * dest        = (uint8_t *)buf;
+    uintptr_t target_addr = (uintptr_t)addr;
+
+    while (len > 0) {
+        uintptr_t page_offset = target_addr % EXTERNAL_EEPROM_PAGE_SIZE;
+        size_t    read_length = EXTERNAL_EEPROM_PAGE_SIZE - page_offset;
+        if (read_length > len) {
+            read_length = len;
+        }
+
+        eeprom_cache_page_t *page = cache_get(target_addr - page_offset, true);
+        memcpy(dest, &page->data[page_offset], read_length);
+
+        dest += read_length;
+        target_addr += read_length;
+        len -= read_length;
+    }
+}
+
+void eeprom_write_block(const void *buf, void *addr, size_t len) {
+    const uint8_t *src         = (const uint8_t *)buf;
+    uintptr_t      target_addr = (uintptr_t)addr;
+
+    while (len > 0) {
+        uintptr_t page_offset  = target_addr % EXTERNAL_EEPROM_PAGE_SIZE;
+        size_t    write_length = EXTERNAL_EEPROM_PAGE_SIZE - page_offset;
+        if (write_length > len) {
+            write_length = len;
+        }
+
+        // A page that gets overwritten completely doesn't need reading first
+        eeprom_cache_page_t *page = cache_get(target_addr - page_offset, write_length < EXTERNAL_EEPROM_PAGE_SIZE);
+        memcpy(&page->data[page_offset], src, write_length);
+        if (page_offset < page->dirty_start) {
+            page->dirty_start = page_offset;
+        }
+        if (page_offset + write_length > page->dirty_end) {
+            page->dirty_end = page_offset + write_length;
+        }
+
+        src += write_length;
+        target_addr += write_length;
+        len -= write_length;
+    }
+
+    cache_dirty       = true;
+    cache_dirty_timer = timer_read32();
+}
+
+void eeprom_driver_flush(void) {
+    if (cache_dirty) {
+        for (uint8_t i = 0; i < EXTERNAL_EEPROM_CACHE_PAGES; i++) {
+            cache_write_back(&cache_pages[i]);
+        }
+        cache_dirty = false;
+    }
+}
+
+void eeprom_driver_task(void) {
+    if (cache_dirty && timer_elapsed32(cache_dirty_timer) >= EXTERNAL_EEPROM_WRITE_BACK_DELAY) {
+        eeprom_driver_flush();
+    }
+}
@@ -0,0 +1,52 @@
+/* Copyright 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+    Write-back page cache in front of the external I2C and SPI EEPROMs. It
+    implements eeprom_read_block() and eeprom_write_block(): reads are served
+    from cached pages, and writes only change the cached copy of a page. Dirty
+    pages go out as a single page write each, once they are evicted, after
+    EXTERNAL_EEPROM_WRITE_BACK_DELAY ms without further writes, or on
+    eeprom_driver_flush().
+*/
+
+/*
+    The number of EEPROM pages held in RAM, each taking
+    EXTERNAL_EEPROM_PAGE_SIZE bytes.
+*/
+#ifndef EXTERNAL_EEPROM_CACHE_PAGES
+#    define EXTERNAL_EEPROM_CACHE_PAGES 2
+#endif
+
+/*
+    How long a dirty page may stay unwritten after the last write to the
+    cache, in milliseconds.
+*/
+#ifndef EXTERNAL_EEPROM_WRITE_BACK_DELAY
+#    define EXTERNAL_EEPROM_WRITE_BACK_DELAY 50
+#endif
+
+// Provided by the bus driver. Writes never cross a page boundary.
+void eeprom_cache_bus_read(uintptr_t addr, uint8_t *buf, size_t len);
+void eeprom_cache_bus_write(uintptr_t addr, const uint8_t *buf, size_t len);
+
+// Drops all cached pages, without writing back dirty ones
+void eeprom_cache_invalidate(void);
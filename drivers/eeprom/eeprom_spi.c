@@ -30,9 +30,11 @@
     there is nothing to override during linkage.
 */
 
-#include "wait.h"
+#include "timer.h"
 #include "spi_master.h"
 #include "eeprom.h"
+#include "eeprom_driver.h"
+#include "eeprom_page_cache.h"
 #include "eeprom_spi.h"
 
 #define CMD_WREN 6
@@ -51,12 +53,13 @@
 #endif
 
 #if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
-#    include "timer.h"
 #    include "debug.h"
 #endif  // CONSOLE_ENABLE
 
 static bool spi_eeprom_start(void) { return spi_start(EXTERNAL_EEPROM_SPI_SLAVE_SELECT_PIN, EXTERNAL_EEPROM_SPI_LSBFIRST, EXTERNAL_EEPROM_SPI_MODE, EXTERNAL_EEPROM_SPI_CLOCK_DIVISOR); }
 
+static spi_device_t spi_eeprom_device;
+
 static spi_status_t spi_eeprom_wait_while_busy(int timeout) {
     uint32_t     deadline = timer_read32() + timeout;
     spi_status_t response;
@@ -70,20 +73,25 @@ static spi_status_t spi_eeprom_wait_while_busy(int timeout) {
     return SPI_STATUS_SUCCESS;
 }
 
-static void spi_eeprom_transmit_address(uintptr_t addr) {
-    uint8_t buffer[EXTERNAL_EEPROM_ADDRESS_SIZE];
-
+static void spi_eeprom_encode_address(uintptr_t addr, uint8_t *buffer) {
     for (int i = 0; i < EXTERNAL_EEPROM_ADDRESS_SIZE; ++i) {
         buffer[EXTERNAL_EEPROM_ADDRESS_SIZE - 1 - i] = addr & 0xFF;
         addr >>= 8;
     }
+}
 
+static void spi_eeprom_transmit_address(uintptr_t addr) {
+    uint8_t buffer[EXTERNAL_EEPROM_ADDRESS_SIZE];
+    spi_eeprom_encode_address(addr, buffer);
     spi_transmit(buffer, EXTERNAL_EEPROM_ADDRESS_SIZE);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
-void eeprom_driver_init(void) { spi_init(); }
+void eeprom_driver_init(void) {
+    spi_init();
+    spi_device_init(&spi_eeprom_device, EXTERNAL_EEPROM_SPI_SLAVE_SELECT_PIN, EXTERNAL_EEPROM_SPI_LSBFIRST, EXTERNAL_EEPROM_SPI_MODE, EXTERNAL_EEPROM_SPI_CLOCK_DIVISOR);
+}
 
 void eeprom_driver_erase(void) {
 #if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
@@ -95,13 +103,14 @@ void eeprom_driver_erase(void) {
     for (uint32_t addr = 0; addr < EXTERNAL_EEPROM_BYTE_COUNT; addr += EXTERNAL_EEPROM_PAGE_SIZE) {
         eeprom_write_block(buf, (void *)(uintptr_t)addr, EXTERNAL_EEPROM_PAGE_SIZE);
     }
+    eeprom_driver_flush();
 
 #if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
     dprintf("EEPROM erase took %ldms to complete\n", ((long)(timer_read32() - start)));
 #endif
 }
 
-void eeprom_read_block(void *buf, const void *addr, size_t len) {
+void eeprom_cache_bus_read(uintptr_t addr, uint8_t *buf, size_t len) {
     //-------------------------------------------------
     // Wait for the write-in-progress bit to be cleared
     bool res = spi_eeprom_start();
@@ -129,13 +138,13 @@ void eeprom_read_block(void *buf, const void *addr, size_t len) {
     }
 
     spi_write(CMD_READ);
-    spi_eeprom_transmit_address((uintptr_t)addr);
+    spi_eeprom_transmit_address(addr);
     spi_receive(buf, len);
 
 #if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
-    dprintf("[EEPROM R] 0x%08lX: ", ((uint32_t)(uintptr_t)addr));
+    dprintf("[EEPROM R] 0x%08lX: ", ((uint32_t)addr));
     for (size_t i = 0; i < len; ++i) {
-        dprintf(" %02X", (int)(((uint8_t *)buf)[i]));
+        dprintf(" %02X", (int)(buf[i]));
     }
     dprintf("\n");
 #endif  // DEBUG_EEPROM_OUTPUT
@@ -143,78 +152,58 @@ void eeprom_read_block(void *buf, const void *addr, size_t len) {
     spi_stop();
 }
 
-void eeprom_write_block(const void *buf, void *addr, size_t len) {
-    bool      res;
-    uint8_t * read_buf    = (uint8_t *)buf;
-    uintptr_t target_addr = (uintptr_t)addr;
-
-    while (len > 0) {
-        uintptr_t page_offset  = target_addr % EXTERNAL_EEPROM_PAGE_SIZE;
-        int       write_length = EXTERNAL_EEPROM_PAGE_SIZE - page_offset;
-        if (write_length > len) {
-            write_length = len;
-        }
-
-        //-------------------------------------------------
-        // Wait for the write-in-progress bit to be cleared
-        res = spi_eeprom_start();
-        if (!res) {
-            dprint("failed to start SPI for WIP check\n");
-            return;
-        }
-
-        spi_status_t response = spi_eeprom_wait_while_busy(EXTERNAL_EEPROM_SPI_TIMEOUT);
-        spi_stop();
-        if (response == SPI_STATUS_TIMEOUT) {
-            dprint("SPI timeout for WIP check\n");
-            return;
-        }
-
-        //-------------------------------------------------
-        // Enable writes
-        res = spi_eeprom_start();
-        if (!res) {
-            dprint("failed to start SPI for write-enable\n");
-            return;
-        }
-
-        spi_write(CMD_WREN);
-        spi_stop();
+void eeprom_cache_bus_write(uintptr_t addr, const uint8_t *buf, size_t len) {
+    //-------------------------------------------------
+    // Wait for the write-in-progress bit to be cleared
+    bool res = spi_eeprom_start();
+    if (!res) {
+        dprint("failed to start SPI for WIP check\n");
+        return;
+    }
 
-        //-------------------------------------------------
-        // Perform the write
-        res = spi_eeprom_start();
-        if (!res) {
-            dprint("failed to start SPI for write\n");
-            return;
-        }
+    spi_status_t response = spi_eeprom_wait_while_busy(EXTERNAL_EEPROM_SPI_TIMEOUT);
+    spi_stop();
+    if (response == SPI_STATUS_TIMEOUT) {
+        dprint("SPI timeout for WIP check\n");
+        return;
+    }
 
 #if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
-        dprintf("[EEPROM W] 0x%08lX: ", ((uint32_t)(uintptr_t)target_addr));
-        for (size_t i = 0; i < write_length; i++) {
-            dprintf(" %02X", (int)(uint8_t)(read_buf[i]));
-        }
-        dprintf("\n");
+    dprintf("[EEPROM W] 0x%08lX: ", ((uint32_t)addr));
+    for (size_t i = 0; i < len; i++) {
+        dprintf(" %02X", (int)(buf[i]));
+    }
+    dprintf("\n");
 #endif  // DEBUG_EEPROM_OUTPUT
 
-        spi_write(CMD_WRITE);
-        spi_eeprom_transmit_address(target_addr);
-        spi_transmit(read_buf, write_length);
-        spi_stop();
-
-        read_buf += write_length;
-        target_addr += write_length;
-        len -= write_length;
+    //-------------------------------------------------
+    // Enable writes, the EEPROM disables them again once the page is written.
+    // Both are queued where the platform can, and the next access waits for
+    // them in its WIP check.
+    static const uint8_t write_enable[] = {CMD_WREN};
+    if (spi_transmit_async(&spi_eeprom_device, write_enable, sizeof(write_enable)) != SPI_STATUS_SUCCESS) {
+        dprint("failed to start SPI for write-enable\n");
+        return;
     }
 
     //-------------------------------------------------
-    // Disable writes
+    // Perform the write
+    static uint8_t packet[1 + EXTERNAL_EEPROM_ADDRESS_SIZE + EXTERNAL_EEPROM_PAGE_SIZE];
+    uint16_t       length = 1 + EXTERNAL_EEPROM_ADDRESS_SIZE + len;
+    packet[0]             = CMD_WRITE;
+    spi_eeprom_encode_address(addr, &packet[1]);
+    memcpy(&packet[1 + EXTERNAL_EEPROM_ADDRESS_SIZE], buf, len);
+    if (spi_transmit_async(&spi_eeprom_device, packet, length) == SPI_STATUS_SUCCESS) {
+        return;
+    }
+
+    // Pages too big to queue are sent directly
     res = spi_eeprom_start();
     if (!res) {
-        dprint("failed to start SPI for write-disable\n");
+        dprint("failed to start SPI for write\n");
         return;
     }
 
-    spi_write(CMD_WRDI);
+    spi_transmit(packet, length);
     spi_stop();
 }
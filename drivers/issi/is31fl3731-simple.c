@@ -128,7 +128,7 @@ void IS31FL3731_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
             if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 17, ISSI_TIMEOUT) == 0) break;
         }
 #else
-        i2c_transmit(addr << 1, g_twi_transfer_buffer, 17, ISSI_TIMEOUT);
+        i2c_transmit_async(addr << 1, g_twi_transfer_buffer, 17, ISSI_TIMEOUT);
 #endif
     }
 }
@@ -217,6 +217,12 @@ void IS31FL3731_set_led_control_register(uint8_t index, bool value) {
 }
 
 void IS31FL3731_update_pwm_buffers(uint8_t addr, uint8_t index) {
+    // Writes are queued, so a failure shows up on a later flush, which then
+    // sends the whole buffer again.
+    if (i2c_async_status(addr << 1) != I2C_STATUS_SUCCESS) {
+        g_pwm_buffer_update_required[index] = true;
+    }
+
     if (g_pwm_buffer_update_required[index]) {
         IS31FL3731_write_pwm_buffer(addr, g_pwm_buffer[index]);
         g_pwm_buffer_update_required[index] = false;
@@ -16,8 +16,10 @@
  */
 
 #include "is31fl3731.h"
+#include <string.h>
 #include "i2c_master.h"
 #include "wait.h"
+#include "issi_dirty.h"
 
 // This is a 7-bit address, that gets left-shifted and bit 0
 // set to 0 for write, 1 for read (as per I2C protocol)
@@ -62,6 +64,7 @@ uint8_t g_twi_transfer_buffer[20];
 // buffers and the transfers in IS31FL3731_write_pwm_buffer() but it's
 // probably not worth the extra complexity.
 uint8_t g_pwm_buffer[DRIVER_COUNT][144];
+uint8_t g_pwm_buffer_dirty[DRIVER_COUNT][ISSI_DIRTY_BYTES(144)];
 bool    g_pwm_buffer_update_required[DRIVER_COUNT] = {false};
 
 uint8_t g_led_control_registers[DRIVER_COUNT][18]             = {{0}};
@@ -178,10 +181,14 @@ void IS31FL3731_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
         is31_led led = g_is31_leds[index];
 
         // Subtract 0x24 to get the second index of g_pwm_buffer
-        g_pwm_buffer[led.driver][led.r - 0x24]   = red;
-        g_pwm_buffer[led.driver][led.g - 0x24]   = green;
-        g_pwm_buffer[led.driver][led.b - 0x24]   = blue;
-        g_pwm_buffer_update_required[led.driver] = true;
+        uint8_t *buffer  = g_pwm_buffer[led.driver];
+        uint8_t *dirty   = g_pwm_buffer_dirty[led.driver];
+        bool     dirty_r = issi_dirty_set(buffer, dirty, led.r - 0x24, red);
+        bool     dirty_g = issi_dirty_set(buffer, dirty, led.g - 0x24, green);
+        bool     dirty_b = issi_dirty_set(buffer, dirty, led.b - 0x24, blue);
+        if (dirty_r || dirty_g || dirty_b) {
+            g_pwm_buffer_update_required[led.driver] = true;
+        }
     }
 }
 
@@ -220,9 +227,47 @@ void IS31FL3731_set_led_control_register(uint8_t index, bool red, bool green, bo
     g_led_control_registers_update_required[led.driver] = true;
 }
 
+// Transmits only the PWM registers changed since the last flush,
+// coalesced into runs of at most 16 bytes.
+// Runs that fail to queue stay dirty and are retried on the next flush.
+static bool IS31FL3731_write_dirty_pwm_buffer(uint8_t addr, uint8_t index) {
+    // assumes bank is already selected
+    uint8_t *pwm_buffer = g_pwm_buffer[index];
+    uint8_t *dirty      = g_pwm_buffer_dirty[index];
+    uint16_t start      = 0;
+    uint8_t  length;
+
+    while ((length = issi_dirty_next_run(dirty, &start, 144, 16)) > 0) {
+        g_twi_transfer_buffer[0] = 0x24 + start;
+        memcpy(g_twi_transfer_buffer + 1, pwm_buffer + start, length);
+
+#if ISSI_PERSISTENCE > 0
+        for (uint8_t i = 0; i < ISSI_PERSISTENCE; i++) {
+            if (i2c_transmit(addr << 1, g_twi_transfer_buffer, length + 1, ISSI_TIMEOUT) == 0) break;
+        }
+#else
+        if (i2c_transmit_async(addr << 1, g_twi_transfer_buffer, length + 1, ISSI_TIMEOUT) != 0) {
+            return false;
+        }
+#endif
+        issi_dirty_clear(dirty, start, length);
+        start += length;
+    }
+    return true;
+}
+
 void IS31FL3731_update_pwm_buffers(uint8_t addr, uint8_t index) {
+    // Writes are queued, so a failure shows up on a later flush. As it is not
+    // known which run failed, everything is sent again.
+    if (i2c_async_status(addr << 1) != I2C_STATUS_SUCCESS) {
+        memset(g_pwm_buffer_dirty[index], 0xFF, sizeof(g_pwm_buffer_dirty[index]));
+        g_pwm_buffer_update_required[index] = true;
+    }
+
     if (g_pwm_buffer_update_required[index]) {
-        IS31FL3731_write_pwm_buffer(addr, g_pwm_buffer[index]);
+        if (!IS31FL3731_write_dirty_pwm_buffer(addr, index)) {
+            return;
+        }
     }
     g_pwm_buffer_update_required[index] = false;
 }
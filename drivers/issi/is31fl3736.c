@@ -15,8 +15,10 @@
  */
 
 #include "is31fl3736.h"
+#include <string.h>
 #include "i2c_master.h"
 #include "wait.h"
+#include "issi_dirty.h"
 
 // This is a 7-bit address, that gets left-shifted and bit 0
 // set to 0 for write, 1 for read (as per I2C protocol)
@@ -64,6 +66,7 @@ uint8_t g_twi_transfer_buffer[20];
 // buffers and the transfers in IS31FL3736_write_pwm_buffer() but it's
 // probably not worth the extra complexity.
 uint8_t g_pwm_buffer[DRIVER_COUNT][192];
+uint8_t g_pwm_buffer_dirty[DRIVER_COUNT][ISSI_DIRTY_BYTES(192)];
 bool    g_pwm_buffer_update_required = false;
 
 uint8_t g_led_control_registers[DRIVER_COUNT][24] = {{0}, {0}};
@@ -153,10 +156,14 @@ void IS31FL3736_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
     if (index >= 0 && index < DRIVER_LED_TOTAL) {
         is31_led led = g_is31_leds[index];
 
-        g_pwm_buffer[led.driver][led.r] = red;
-        g_pwm_buffer[led.driver][led.g] = green;
-        g_pwm_buffer[led.driver][led.b] = blue;
-        g_pwm_buffer_update_required    = true;
+        uint8_t *buffer  = g_pwm_buffer[led.driver];
+        uint8_t *dirty   = g_pwm_buffer_dirty[led.driver];
+        bool     dirty_r = issi_dirty_set(buffer, dirty, led.r, red);
+        bool     dirty_g = issi_dirty_set(buffer, dirty, led.g, green);
+        bool     dirty_b = issi_dirty_set(buffer, dirty, led.b, blue);
+        if (dirty_r || dirty_g || dirty_b) {
+            g_pwm_buffer_update_required = true;
+        }
     }
 }
 
@@ -213,9 +220,10 @@ void IS31FL3736_mono_set_brightness(int index, uint8_t value) {
     if (index >= 0 && index < 96) {
         // Index in range 0..95 -> A1..A8, B1..B8, etc.
         // Map index 0..95 to registers 0x00..0xBE (interleaved)
-        uint8_t pwm_register          = index * 2;
-        g_pwm_buffer[0][pwm_register] = value;
-        g_pwm_buffer_update_required  = true;
+        uint8_t pwm_register = index * 2;
+        if (issi_dirty_set(g_pwm_buffer[0], g_pwm_buffer_dirty[0], pwm_register, value)) {
+            g_pwm_buffer_update_required = true;
+        }
     }
 }
 
@@ -243,14 +251,52 @@ void IS31FL3736_mono_set_led_control_register(uint8_t index, bool enabled) {
     g_led_control_registers_update_required = true;
 }
 
+// Transmits only the PWM registers changed since the last flush,
+// coalesced into runs of at most 16 bytes.
+// Runs that fail to queue stay dirty and are retried on the next flush.
+static bool IS31FL3736_write_dirty_pwm_buffer(uint8_t addr, uint8_t index) {
+    // assumes PG1 is already selected
+    uint8_t *pwm_buffer = g_pwm_buffer[index];
+    uint8_t *dirty      = g_pwm_buffer_dirty[index];
+    uint16_t start      = 0;
+    uint8_t  length;
+
+    while ((length = issi_dirty_next_run(dirty, &start, 192, 16)) > 0) {
+        g_twi_transfer_buffer[0] = start;
+        memcpy(g_twi_transfer_buffer + 1, pwm_buffer + start, length);
+
+#if ISSI_PERSISTENCE > 0
+        for (uint8_t i = 0; i < ISSI_PERSISTENCE; i++) {
+            if (i2c_transmit(addr << 1, g_twi_transfer_buffer, length + 1, ISSI_TIMEOUT) == 0) break;
+        }
+#else
+        if (i2c_transmit_async(addr << 1, g_twi_transfer_buffer, length + 1, ISSI_TIMEOUT) != 0) {
+            return false;
+        }
+#endif
+        issi_dirty_clear(dirty, start, length);
+        start += length;
+    }
+    return true;
+}
+
 void IS31FL3736_update_pwm_buffers(uint8_t addr1, uint8_t addr2) {
+    // Writes are queued, so a failure shows up on a later flush. As it is not
+    // known which run failed, everything is sent again.
+    if (i2c_async_status(addr1 << 1) != I2C_STATUS_SUCCESS) {
+        memset(g_pwm_buffer_dirty[0], 0xFF, sizeof(g_pwm_buffer_dirty[0]));
+        g_pwm_buffer_update_required = true;
+    }
+
     if (g_pwm_buffer_update_required) {
         // Firstly we need to unlock the command register and select PG1
         IS31FL3736_write_register(addr1, ISSI_COMMANDREGISTER_WRITELOCK, 0xC5);
         IS31FL3736_write_register(addr1, ISSI_COMMANDREGISTER, ISSI_PAGE_PWM);
 
-        IS31FL3736_write_pwm_buffer(addr1, g_pwm_buffer[0]);
-        // IS31FL3736_write_pwm_buffer(addr2, g_pwm_buffer[1]);
+        if (!IS31FL3736_write_dirty_pwm_buffer(addr1, 0)) {
+            return;
+        }
+        // IS31FL3736_write_dirty_pwm_buffer(addr2, 1);
     }
     g_pwm_buffer_update_required = false;
 }
@@ -23,6 +23,7 @@
 #include <string.h>
 #include "i2c_master.h"
 #include "progmem.h"
+#include "issi_dirty.h"
 
 // This is a 7-bit address, that gets left-shifted and bit 0
 // set to 0 for write, 1 for read (as per I2C protocol)
@@ -73,6 +74,7 @@ uint8_t g_twi_transfer_buffer[20] = {0xFF};
 // buffers and the transfers in IS31FL3741_write_pwm_buffer() but it's
 // probably not worth the extra complexity.
 uint8_t g_pwm_buffer[DRIVER_COUNT][ISSI_MAX_LEDS];
+uint8_t g_pwm_buffer_dirty[DRIVER_COUNT][ISSI_DIRTY_BYTES(ISSI_MAX_LEDS)];
 bool    g_pwm_buffer_update_required                      = false;
 bool    g_scaling_registers_update_required[DRIVER_COUNT] = {false};
 
@@ -169,10 +171,7 @@ void IS31FL3741_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
     if (index >= 0 && index < DRIVER_LED_TOTAL) {
         is31_led led = g_is31_leds[index];
 
-        g_pwm_buffer[led.driver][led.r] = red;
-        g_pwm_buffer[led.driver][led.g] = green;
-        g_pwm_buffer[led.driver][led.b] = blue;
-        g_pwm_buffer_update_required    = true;
+        IS31FL3741_set_pwm_buffer(&led, red, green, blue);
     }
 }
 
@@ -206,20 +205,90 @@ void IS31FL3741_set_led_control_register(uint8_t index, bool red, bool green, bo
     g_scaling_registers_update_required[led.driver] = true;
 }
 
+// Transmits the dirty PWM registers in [start, end) as runs of at most 18
+// bytes. The caller selects the page; page_base is its first register.
+static bool IS31FL3741_write_dirty_pwm_page(uint8_t addr, uint8_t index, uint16_t start, uint16_t end, uint16_t page_base) {
+    uint8_t *pwm_buffer = g_pwm_buffer[index];
+    uint8_t *dirty      = g_pwm_buffer_dirty[index];
+    uint8_t  length;
+
+    while ((length = issi_dirty_next_run(dirty, &start, end, 18)) > 0) {
+        g_twi_transfer_buffer[0] = start - page_base;
+        memcpy(g_twi_transfer_buffer + 1, pwm_buffer + start, length);
+
+#if ISSI_PERSISTENCE > 0
+        for (uint8_t i = 0; i < ISSI_PERSISTENCE; i++) {
+            if (i2c_transmit(addr << 1, g_twi_transfer_buffer, length + 1, ISSI_TIMEOUT) != 0) {
+                return false;
+            }
+        }
+#else
+        if (i2c_transmit_async(addr << 1, g_twi_transfer_buffer, length + 1, ISSI_TIMEOUT) != 0) {
+            return false;
+        }
+#endif
+        issi_dirty_clear(dirty, start, length);
+        start += length;
+    }
+    return true;
+}
+
+// Transmits only the PWM registers changed since the last flush, selecting
+// each page only when it has something to send.
+static bool IS31FL3741_write_dirty_pwm_buffer(uint8_t addr, uint8_t index) {
+    uint16_t start = 0;
+
+    if (issi_dirty_next_run(g_pwm_buffer_dirty[index], &start, 180, 1) > 0) {
+        // unlock the command register and select PG0
+        IS31FL3741_write_register(addr, ISSI_COMMANDREGISTER_WRITELOCK, 0xC5);
+        IS31FL3741_write_register(addr, ISSI_COMMANDREGISTER, ISSI_PAGE_PWM0);
+
+        if (!IS31FL3741_write_dirty_pwm_page(addr, index, start, 180, 0)) {
+            return false;
+        }
+    }
+
+    start = 180;
+    if (issi_dirty_next_run(g_pwm_buffer_dirty[index], &start, ISSI_MAX_LEDS, 1) > 0) {
+        // unlock the command register and select PG1
+        IS31FL3741_write_register(addr, ISSI_COMMANDREGISTER_WRITELOCK, 0xC5);
+        IS31FL3741_write_register(addr, ISSI_COMMANDREGISTER, ISSI_PAGE_PWM1);
+
+        if (!IS31FL3741_write_dirty_pwm_page(addr, index, start, ISSI_MAX_LEDS, 180)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void IS31FL3741_update_pwm_buffers(uint8_t addr1, uint8_t addr2) {
+    // Writes are queued, so a failure shows up on a later flush. As it is not
+    // known which run failed, everything is sent again.
+    if (i2c_async_status(addr1 << 1) != I2C_STATUS_SUCCESS) {
+        memset(g_pwm_buffer_dirty[0], 0xFF, sizeof(g_pwm_buffer_dirty[0]));
+        g_pwm_buffer_update_required = true;
+    }
+
     if (g_pwm_buffer_update_required) {
-        IS31FL3741_write_pwm_buffer(addr1, g_pwm_buffer[0]);
+        // Runs that fail to transmit stay dirty and are retried next time.
+        if (!IS31FL3741_write_dirty_pwm_buffer(addr1, 0)) {
+            return;
+        }
     }
 
     g_pwm_buffer_update_required = false;
 }
 
 void IS31FL3741_set_pwm_buffer(const is31_led *pled, uint8_t red, uint8_t green, uint8_t blue) {
-    g_pwm_buffer[pled->driver][pled->r] = red;
-    g_pwm_buffer[pled->driver][pled->g] = green;
-    g_pwm_buffer[pled->driver][pled->b] = blue;
-
-    g_pwm_buffer_update_required = true;
+    uint8_t *buffer  = g_pwm_buffer[pled->driver];
+    uint8_t *dirty   = g_pwm_buffer_dirty[pled->driver];
+    bool     dirty_r = issi_dirty_set(buffer, dirty, pled->r, red);
+    bool     dirty_g = issi_dirty_set(buffer, dirty, pled->g, green);
+    bool     dirty_b = issi_dirty_set(buffer, dirty, pled->b, blue);
+
+    if (dirty_r || dirty_g || dirty_b) {
+        g_pwm_buffer_update_required = true;
+    }
 }
 
 void IS31FL3741_update_led_control_registers(uint8_t addr, uint8_t index) {
@@ -0,0 +1,90 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Per-register dirty tracking shared by the ISSI PWM drivers.
+//
+// set_color() marks a register dirty only when its value actually changes,
+// and the flush walks the bitmap emitting contiguous runs of dirty registers
+// so static effects cost no bus time at all.
+
+// Clean registers a run may absorb rather than being split in two. Each extra
+// transfer costs a start condition, the device address and the register
+// byte, so bridging a gap of up to two registers is never more expensive.
+#ifndef ISSI_DIRTY_RUN_GAP
+#    define ISSI_DIRTY_RUN_GAP 2
+#endif
+
+#define ISSI_DIRTY_BYTES(registers) (((registers) + 7) / 8)
+
+static inline bool issi_dirty_test(const uint8_t *dirty, uint16_t reg) { return dirty[reg >> 3] & (1 << (reg & 7)); }
+
+static inline void issi_dirty_mark(uint8_t *dirty, uint16_t reg) { dirty[reg >> 3] |= (1 << (reg & 7)); }
+
+// Stores value in buffer[reg], marking the register dirty if it changed.
+// Returns true if the register was modified.
+static inline bool issi_dirty_set(uint8_t *buffer, uint8_t *dirty, uint16_t reg, uint8_t value) {
+    if (buffer[reg] == value) {
+        return false;
+    }
+    buffer[reg] = value;
+    issi_dirty_mark(dirty, reg);
+    return true;
+}
+
+static inline void issi_dirty_clear(uint8_t *dirty, uint16_t start, uint8_t length) {
+    for (uint16_t reg = start; reg < start + length; reg++) {
+        dirty[reg >> 3] &= ~(1 << (reg & 7));
+    }
+}
+
+// Finds the next run of dirty registers in [*start, end), bridging gaps of up
+// to ISSI_DIRTY_RUN_GAP clean registers, and at most max_length long.
+// On return *start is the first register of the run; returns its length, or 0
+// once no dirty registers remain.
+static inline uint8_t issi_dirty_next_run(const uint8_t *dirty, uint16_t *start, uint16_t end, uint8_t max_length) {
+    uint16_t reg = *start;
+
+    while (reg < end && !issi_dirty_test(dirty, reg)) {
+        // Skip clean bytes of the bitmap eight registers at a time.
+        if ((reg & 7) == 0 && dirty[reg >> 3] == 0) {
+            reg += 8;
+        } else {
+            reg++;
+        }
+    }
+    if (reg >= end) {
+        *start = end;
+        return 0;
+    }
+
+    *start         = reg;
+    uint16_t last  = reg;
+    uint16_t limit = reg + max_length;
+    if (limit > end) {
+        limit = end;
+    }
+    for (reg++; reg < limit && reg - last <= ISSI_DIRTY_RUN_GAP + 1; reg++) {
+        if (issi_dirty_test(dirty, reg)) {
+            last = reg;
+        }
+    }
+    return last - *start + 1;
+}
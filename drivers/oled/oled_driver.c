@@ -101,6 +101,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #endif  // defined(__AVR__)
 #define I2C_TRANSMIT(data) i2c_transmit((OLED_DISPLAY_ADDRESS << 1), &data[0], sizeof(data), OLED_I2C_TIMEOUT)
 #define I2C_WRITE_REG(mode, data, size) i2c_writeReg((OLED_DISPLAY_ADDRESS << 1), mode, data, size, OLED_I2C_TIMEOUT)
+#define I2C_TRANSMIT_ASYNC(data) i2c_transmit_async((OLED_DISPLAY_ADDRESS << 1), &data[0], sizeof(data), OLED_I2C_TIMEOUT)
+#define I2C_WRITE_REG_ASYNC(mode, data, size) i2c_writeReg_async((OLED_DISPLAY_ADDRESS << 1), mode, data, size, OLED_I2C_TIMEOUT)
 
 #define HAS_FLAGS(bits, flags) ((bits & flags) == flags)
 
@@ -238,13 +240,21 @@ void oled_clear(void) {
     oled_dirty  = OLED_ALL_BLOCKS_MASK;
 }
 
-static void calc_bounds(uint8_t update_start, uint8_t *cmd_array) {
+// Sets the addressing window for sending oled_buffer from start to *end.
+// Returns where the data has to start from, and trims *end to what fits
+// in one burst.
+static uint16_t calc_bounds(uint16_t start, uint16_t *end, uint8_t *cmd_array) {
     // Calculate commands to set memory addressing bounds.
-    uint8_t start_page   = OLED_BLOCK_SIZE * update_start / OLED_DISPLAY_WIDTH;
-    uint8_t start_column = OLED_BLOCK_SIZE * update_start % OLED_DISPLAY_WIDTH;
+    uint8_t start_page   = start / OLED_DISPLAY_WIDTH;
+    uint8_t start_column = start % OLED_DISPLAY_WIDTH;
+    uint8_t end_page     = (*end - 1) / OLED_DISPLAY_WIDTH;
 #if (OLED_IC == OLED_IC_SH1106)
     // Commands for Page Addressing Mode. Sets starting page and column; has no end bound.
     // Column value must be split into high and low nybble and sent as two commands.
+    // The column doesn't move on to the next page, so the burst stops at the end of this one.
+    if (end_page != start_page) {
+        *end = (start_page + 1) * OLED_DISPLAY_WIDTH;
+    }
     cmd_array[0] = PAM_PAGE_ADDR | start_page;
     cmd_array[1] = PAM_SETCOLUMN_LSB | ((OLED_COLUMN_OFFSET + start_column) & 0x0f);
     cmd_array[2] = PAM_SETCOLUMN_MSB | ((OLED_COLUMN_OFFSET + start_column) >> 4 & 0x0f);
@@ -253,18 +263,24 @@ static void calc_bounds(uint8_t update_start, uint8_t *cmd_array) {
     cmd_array[5] = NOP;
 #else
     // Commands for use in Horizontal Addressing mode.
+    // Each page starts again at the first column of the window, so a burst
+    // across pages uses full rows and starts at the beginning of the first.
+    if (end_page != start_page) {
+        start -= start_column;
+        start_column = 0;
+    }
     cmd_array[1] = start_column;
     cmd_array[4] = start_page;
-    cmd_array[2] = (OLED_BLOCK_SIZE + OLED_DISPLAY_WIDTH - 1) % OLED_DISPLAY_WIDTH + cmd_array[1];
-    cmd_array[5] = (OLED_BLOCK_SIZE + OLED_DISPLAY_WIDTH - 1) / OLED_DISPLAY_WIDTH - 1;
+    cmd_array[2] = end_page != start_page ? OLED_DISPLAY_WIDTH - 1 : (*end - 1) % OLED_DISPLAY_WIDTH;
+    cmd_array[5] = end_page;
 #endif
+    return start;
 }
 
-static void calc_bounds_90(uint8_t update_start, uint8_t *cmd_array) {
+static void calc_bounds_90(uint8_t update_start, uint8_t count, uint8_t *cmd_array) {
     cmd_array[1] = OLED_BLOCK_SIZE * update_start / OLED_DISPLAY_HEIGHT * 8;
     cmd_array[4] = OLED_BLOCK_SIZE * update_start % OLED_DISPLAY_HEIGHT;
-    cmd_array[2] = (OLED_BLOCK_SIZE + OLED_DISPLAY_HEIGHT - 1) / OLED_DISPLAY_HEIGHT * 8 - 1 + cmd_array[1];
-    ;
+    cmd_array[2] = (OLED_BLOCK_SIZE + OLED_DISPLAY_HEIGHT - 1) / OLED_DISPLAY_HEIGHT * 8 * count - 1 + cmd_array[1];
     cmd_array[5] = (OLED_BLOCK_SIZE + OLED_DISPLAY_HEIGHT - 1) % OLED_DISPLAY_HEIGHT / 8;
 }
 
@@ -274,13 +290,79 @@ uint8_t crot(uint8_t a, int8_t n) {
     return a << n | a >> (-n & mask);
 }
 
+// Transposes an 8x8 bit matrix, so that bit i of dest[7 - j] is bit j of
+// src[i]. Swaps 1x1, then 2x2 and then 4x4 sub-matrices, two rows of the
+// matrix per 32 bit word.
 static void rotate_90(const uint8_t *src, uint8_t *dest) {
-    for (uint8_t i = 0, shift = 7; i < 8; ++i, --shift) {
-        uint8_t selector = (1 << i);
-        for (uint8_t j = 0; j < 8; ++j) {
-            dest[i] |= crot(src[j] & selector, shift - (int8_t)j);
+    uint32_t x = (uint32_t)src[0] << 24 | (uint32_t)src[1] << 16 | (uint32_t)src[2] << 8 | src[3];
+    uint32_t y = (uint32_t)src[4] << 24 | (uint32_t)src[5] << 16 | (uint32_t)src[6] << 8 | src[7];
+    uint32_t t;
+
+    t = (x ^ (x >> 7)) & 0x00AA00AA;
+    x = x ^ t ^ (t << 7);
+    t = (y ^ (y >> 7)) & 0x00AA00AA;
+    y = y ^ t ^ (t << 7);
+
+    t = (x ^ (x >> 14)) & 0x0000CCCC;
+    x = x ^ t ^ (t << 14);
+    t = (y ^ (y >> 14)) & 0x0000CCCC;
+    y = y ^ t ^ (t << 14);
+
+    t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+    y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+
+    dest[7] = t >> 24;
+    dest[6] = t >> 16;
+    dest[5] = t >> 8;
+    dest[4] = t;
+    dest[3] = y >> 24;
+    dest[2] = y >> 16;
+    dest[1] = y >> 8;
+    dest[0] = y;
+}
+
+// The display appends each write to the last, so the data is split into
+// page sized writes to bound the size of each transfer
+static bool oled_send_data(const uint8_t *data, uint16_t length) {
+    while (length > 0) {
+        uint16_t size = length < OLED_DISPLAY_WIDTH ? length : OLED_DISPLAY_WIDTH;
+        if (I2C_WRITE_REG_ASYNC(I2C_DATA, data, size) != I2C_STATUS_SUCCESS) {
+            return false;
         }
+        data += size;
+        length -= size;
     }
+    return true;
+}
+
+// Rotates blocks [update_start, update_end) and sends them page by page,
+// as the window of the merged blocks is filled.
+static bool oled_send_rotated(uint8_t update_start, uint8_t update_end) {
+    const static uint8_t source_map[] = OLED_SOURCE_MAP;
+    const static uint8_t target_map[] = OLED_TARGET_MAP;
+    // Columns of the window one block covers
+    const uint8_t width = (OLED_BLOCK_SIZE + OLED_DISPLAY_HEIGHT - 1) / OLED_DISPLAY_HEIGHT * 8;
+
+    static uint8_t temp_buffer[OLED_BLOCK_SIZE];
+    uint16_t       fill = 0;
+    for (uint8_t page = 0; page < OLED_BLOCK_SIZE / width; ++page) {
+        for (uint8_t block = update_start; block < update_end; ++block) {
+            for (uint8_t i = 0; i < sizeof(source_map); ++i) {
+                if (target_map[i] / width == page) {
+                    rotate_90(&oled_buffer[OLED_BLOCK_SIZE * block + source_map[i]], &temp_buffer[fill + target_map[i] % width]);
+                }
+            }
+            fill += width;
+
+            if (fill + width > sizeof(temp_buffer)) {
+                if (!oled_send_data(temp_buffer, fill)) {
+                    return false;
+                }
+                fill = 0;
+            }
+        }
+    }
+    return fill == 0 || oled_send_data(temp_buffer, fill);
 }
 
 void oled_render(void) {
@@ -288,51 +370,62 @@ void oled_render(void) {
         return;
     }
 
+    // Blocks are queued rather than sent, so a failure shows up here on a
+    // later render. Redraw everything as it is not known which block failed.
+    if (i2c_async_status((OLED_DISPLAY_ADDRESS << 1)) != I2C_STATUS_SUCCESS) {
+        print("oled_render queued data failed\n");
+        oled_dirty = OLED_ALL_BLOCKS_MASK;
+    }
+
     // Do we have work to do?
     oled_dirty &= OLED_ALL_BLOCKS_MASK;
     if (!oled_dirty || oled_scrolling) {
         return;
     }
 
-    // Find first dirty block
+    // Find first run of dirty blocks, which is sent as one burst
     uint8_t update_start = 0;
     while (!(oled_dirty & ((OLED_BLOCK_TYPE)1 << update_start))) {
         ++update_start;
     }
+    uint8_t update_end = update_start + 1;
+    while (update_end < OLED_BLOCK_COUNT && (oled_dirty & ((OLED_BLOCK_TYPE)1 << update_end))) {
+        ++update_end;
+    }
 
     // Set column & page position
     static uint8_t display_start[] = {I2C_CMD, COLUMN_ADDR, 0, OLED_DISPLAY_WIDTH - 1, PAGE_ADDR, 0, OLED_DISPLAY_HEIGHT / 8 - 1};
+    uint16_t       data_start      = 0;
+    uint16_t       data_end        = 0;
     if (!HAS_FLAGS(oled_rotation, OLED_ROTATION_90)) {
-        calc_bounds(update_start, &display_start[1]);  // Offset from I2C_CMD byte at the start
+        data_end   = OLED_BLOCK_SIZE * update_end;
+        data_start = calc_bounds(OLED_BLOCK_SIZE * update_start, &data_end, &display_start[1]);  // Offset from I2C_CMD byte at the start
+        // Blocks cut off at the end of the burst stay dirty
+        update_end = data_end / OLED_BLOCK_SIZE > update_start ? data_end / OLED_BLOCK_SIZE : update_start + 1;
     } else {
-        calc_bounds_90(update_start, &display_start[1]);  // Offset from I2C_CMD byte at the start
+        // Rotated blocks can only be merged when each one covers the full
+        // height of the display, and not at all in Page Addressing Mode
+        if (OLED_BLOCK_SIZE % OLED_DISPLAY_HEIGHT != 0 || OLED_IC == OLED_IC_SH1106) {
+            update_end = update_start + 1;
+        }
+        calc_bounds_90(update_start, update_end - update_start, &display_start[1]);  // Offset from I2C_CMD byte at the start
     }
 
     // Send column & page position
-    if (I2C_TRANSMIT(display_start) != I2C_STATUS_SUCCESS) {
+    if (I2C_TRANSMIT_ASYNC(display_start) != I2C_STATUS_SUCCESS) {
         print("oled_render offset command failed\n");
         return;
     }
 
     if (!HAS_FLAGS(oled_rotation, OLED_ROTATION_90)) {
-        // Send render data chunk as is
-        if (I2C_WRITE_REG(I2C_DATA, &oled_buffer[OLED_BLOCK_SIZE * update_start], OLED_BLOCK_SIZE) != I2C_STATUS_SUCCESS) {
+        // Send render data as is
+        if (!oled_send_data(&oled_buffer[data_start], data_end - data_start)) {
             print("oled_render data failed\n");
             return;
         }
     } else {
-        // Rotate the render chunks
-        const static uint8_t source_map[] = OLED_SOURCE_MAP;
-        const static uint8_t target_map[] = OLED_TARGET_MAP;
-
-        static uint8_t temp_buffer[OLED_BLOCK_SIZE];
-        memset(temp_buffer, 0, sizeof(temp_buffer));
-        for (uint8_t i = 0; i < sizeof(source_map); ++i) {
-            rotate_90(&oled_buffer[OLED_BLOCK_SIZE * update_start + source_map[i]], &temp_buffer[target_map[i]]);
-        }
-
-        // Send render data chunk after rotating
-        if (I2C_WRITE_REG(I2C_DATA, &temp_buffer[0], OLED_BLOCK_SIZE) != I2C_STATUS_SUCCESS) {
+        // Send render data after rotating
+        if (!oled_send_rotated(update_start, update_end)) {
             print("oled_render90 data failed\n");
             return;
         }
@@ -341,8 +434,10 @@ void oled_render(void) {
     // Turn on display if it is off
     oled_on();
 
-    // Clear dirty flag
-    oled_dirty &= ~((OLED_BLOCK_TYPE)1 << update_start);
+    // Clear dirty flags
+    for (uint8_t i = update_start; i < update_end; ++i) {
+        oled_dirty &= ~((OLED_BLOCK_TYPE)1 << i);
+    }
 }
 
 void oled_set_cursor(uint8_t col, uint8_t line) {
@@ -517,6 +612,174 @@ void oled_write_pixel(uint8_t x, uint8_t y, bool on) {
     }
 }
 
+// Height of the buffer in the current rotation
+static uint16_t oled_rotation_height(void) { return OLED_MATRIX_SIZE / oled_rotation_width * 8; }
+
+// Updates the bytes of width columns from index as ((data & keep) | set) ^ flip.
+// Returns the blocks that changed, so callers update oled_dirty once.
+static OLED_BLOCK_TYPE oled_update_span(uint16_t index, uint8_t width, uint8_t keep, uint8_t set, uint8_t flip) {
+    OLED_BLOCK_TYPE dirty = 0;
+    for (uint16_t end = index + width; index < end; ++index) {
+        uint8_t data = ((oled_buffer[index] & keep) | set) ^ flip;
+        if (oled_buffer[index] != data) {
+            oled_buffer[index] = data;
+            dirty |= ((OLED_BLOCK_TYPE)1 << (index / OLED_BLOCK_SIZE));
+        }
+    }
+    return dirty;
+}
+
+// Applies a fill or invert to a rectangle one page at a time, with a mask
+// for the rows it covers in each page
+static void oled_update_rect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, bool on, bool invert) {
+    uint16_t rotation_height = oled_rotation_height();
+    if (x >= oled_rotation_width || y >= rotation_height || !width || !height) {
+        return;
+    }
+    if (width > oled_rotation_width - x) {
+        width = oled_rotation_width - x;
+    }
+    if (height > rotation_height - y) {
+        height = rotation_height - y;
+    }
+
+    OLED_BLOCK_TYPE dirty = 0;
+    uint16_t        end   = y + height;
+    for (uint16_t row = y; row < end; row = (row | 7) + 1) {
+        uint8_t mask = 0xFF << (row & 7);
+        if (end < (row | 7) + 1) {
+            mask &= 0xFF >> ((row | 7) + 1 - end);
+        }
+
+        uint16_t index = x + row / 8 * oled_rotation_width;
+        if (invert) {
+            dirty |= oled_update_span(index, width, 0xFF, 0, mask);
+        } else {
+            dirty |= oled_update_span(index, width, ~mask, on ? mask : 0, 0);
+        }
+    }
+    oled_dirty |= dirty;
+}
+
+void oled_draw_hline(uint8_t x, uint8_t y, uint8_t width, bool on) { oled_update_rect(x, y, width, 1, on, false); }
+
+void oled_draw_vline(uint8_t x, uint8_t y, uint8_t height, bool on) { oled_update_rect(x, y, 1, height, on, false); }
+
+void oled_fill_rect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, bool on) { oled_update_rect(x, y, width, height, on, false); }
+
+void oled_invert_rect(uint8_t x, uint8_t y, uint8_t width, uint8_t height) { oled_update_rect(x, y, width, height, false, true); }
+
+void oled_draw_rect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, bool on) {
+    if (!width || !height) {
+        return;
+    }
+    // Edges past the end of the coordinates are off the display anyway
+    oled_update_rect(x, y, width, 1, on, false);
+    if (y + height - 1 <= UINT8_MAX) {
+        oled_update_rect(x, y + height - 1, width, 1, on, false);
+    }
+    oled_update_rect(x, y, 1, height, on, false);
+    if (x + width - 1 <= UINT8_MAX) {
+        oled_update_rect(x + width - 1, y, 1, height, on, false);
+    }
+}
+
+void oled_draw_line(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool on) {
+    if (y0 == y1) {
+        oled_draw_hline(x0 < x1 ? x0 : x1, y0, (x0 < x1 ? x1 - x0 : x0 - x1) + 1, on);
+        return;
+    }
+    if (x0 == x1) {
+        oled_draw_vline(x0, y0 < y1 ? y0 : y1, (y0 < y1 ? y1 - y0 : y0 - y1) + 1, on);
+        return;
+    }
+
+    // Bresenham's line algorithm, working on the buffer directly
+    uint16_t        rotation_height = oled_rotation_height();
+    int16_t         dx              = x0 < x1 ? x1 - x0 : x0 - x1;
+    int16_t         dy              = y0 < y1 ? y0 - y1 : y1 - y0;
+    int8_t          sx              = x0 < x1 ? 1 : -1;
+    int8_t          sy              = y0 < y1 ? 1 : -1;
+    int16_t         err             = dx + dy;
+    OLED_BLOCK_TYPE dirty           = 0;
+    while (true) {
+        if (x0 < oled_rotation_width && y0 < rotation_height) {
+            uint16_t index = x0 + (y0 / 8) * oled_rotation_width;
+            uint8_t  data  = on ? oled_buffer[index] | (1 << (y0 % 8)) : oled_buffer[index] & ~(1 << (y0 % 8));
+            if (oled_buffer[index] != data) {
+                oled_buffer[index] = data;
+                dirty |= ((OLED_BLOCK_TYPE)1 << (index / OLED_BLOCK_SIZE));
+            }
+        }
+        if (x0 == x1 && y0 == y1) {
+            break;
+        }
+        int16_t e2 = 2 * err;
+        if (e2 >= dy) {
+            err += dy;
+            x0 += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y0 += sy;
+        }
+    }
+    oled_dirty |= dirty;
+}
+
+// Copies each byte of the bitmap into the one or two pages it straddles,
+// shifted into place and masked to the rows that are on the display
+static void oled_draw_bitmap_impl(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t width, uint8_t height, bool progmem) {
+    int16_t rotation_height = oled_rotation_height();
+    if (x >= oled_rotation_width || y >= rotation_height || x + width <= 0 || y + height <= 0) {
+        return;
+    }
+
+    int16_t first_column = x < 0 ? -x : 0;
+    int16_t last_column  = x + width > oled_rotation_width ? oled_rotation_width - x : width;
+    int16_t first_row    = y < 0 ? -y : 0;
+    int16_t last_row     = y + height > rotation_height ? rotation_height - y : height;
+
+    OLED_BLOCK_TYPE dirty = 0;
+    for (int16_t source_row = first_row & ~7; source_row < last_row; source_row += 8) {
+        // Rows of this page of the bitmap that are drawn
+        uint8_t mask = 0xFF;
+        if (first_row > source_row) {
+            mask <<= first_row - source_row;
+        }
+        if (last_row < source_row + 8) {
+            mask &= 0xFF >> (source_row + 8 - last_row);
+        }
+
+        // Display rows are never negative once masked, so the offset keeps
+        // the division from rounding towards zero
+        int16_t  row   = y + source_row;
+        uint8_t  shift = (row + 256) & 7;
+        int16_t  page  = (row + 256) / 8 - 32;
+        uint8_t  low   = mask << shift;
+        uint8_t  high  = shift ? mask >> (8 - shift) : 0;
+        uint16_t pages = rotation_height / 8;
+
+        const uint8_t *source = &bitmap[source_row / 8 * width];
+        for (int16_t column = first_column; column < last_column; ++column) {
+            uint8_t data = progmem ? pgm_read_byte(&source[column]) : source[column];
+            if (low && page >= 0) {
+                dirty |= oled_update_span(x + column + page * oled_rotation_width, 1, ~low, (data << shift) & low, 0);
+            }
+            if (high && page + 1 < pages) {
+                dirty |= oled_update_span(x + column + (page + 1) * oled_rotation_width, 1, ~high, (data >> (8 - shift)) & high, 0);
+            }
+        }
+    }
+    oled_dirty |= dirty;
+}
+
+void oled_draw_bitmap(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t width, uint8_t height) { oled_draw_bitmap_impl(x, y, bitmap, width, height, false); }
+
+#if defined(__AVR__)
+void oled_draw_bitmap_P(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t width, uint8_t height) { oled_draw_bitmap_impl(x, y, bitmap, width, height, true); }
+#endif
+
 #if defined(__AVR__)
 void oled_write_P(const char *data, bool invert) {
     uint8_t c = pgm_read_byte(data);
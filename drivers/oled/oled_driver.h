@@ -239,6 +239,33 @@ void oled_write_raw_byte(const char data, uint16_t index);
 // Coordinates start at top-left and go right and down for positive x and y
 void oled_write_pixel(uint8_t x, uint8_t y, bool on);
 
+// Drawing primitives work on whole bytes of the buffer where they can, and
+// clip to the display. They use the same coordinates as oled_write_pixel.
+
+// Sets or clears a horizontal line of width pixels starting at x, y
+void oled_draw_hline(uint8_t x, uint8_t y, uint8_t width, bool on);
+
+// Sets or clears a vertical line of height pixels starting at x, y
+void oled_draw_vline(uint8_t x, uint8_t y, uint8_t height, bool on);
+
+// Sets or clears a line from x0, y0 to x1, y1, both ends included
+void oled_draw_line(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool on);
+
+// Sets or clears the outline of a rectangle with its top-left corner at x, y
+void oled_draw_rect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, bool on);
+
+// Sets or clears every pixel of a rectangle with its top-left corner at x, y
+void oled_fill_rect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, bool on);
+
+// Flips every pixel of a rectangle with its top-left corner at x, y
+void oled_invert_rect(uint8_t x, uint8_t y, uint8_t width, uint8_t height);
+
+// Copies a bitmap of width x height pixels to x, y, which may be partly off
+// the display. The bitmap uses the layout of the buffer: each byte is a
+// column of 8 pixels, with the least significant bit at the top, and each
+// 8 pixel high row of the bitmap is width bytes long.
+void oled_draw_bitmap(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t width, uint8_t height);
+
 #if defined(__AVR__)
 // Writes a PROGMEM string to the buffer at current cursor position
 // Advances the cursor while writing, inverts the pixels if true
@@ -252,6 +279,10 @@ void oled_write_P(const char *data, bool invert);
 void oled_write_ln_P(const char *data, bool invert);
 
 void oled_write_raw_P(const char *data, uint16_t size);
+
+// Copies a PROGMEM bitmap to x, y, see oled_draw_bitmap
+// Remapped to call 'void oled_draw_bitmap(...);' on ARM
+void oled_draw_bitmap_P(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t width, uint8_t height);
 #else
 // Writes a string to the buffer at current cursor position
 // Advances the cursor while writing, inverts the pixels if true
@@ -263,6 +294,8 @@ void oled_write_raw_P(const char *data, uint16_t size);
 #    define oled_write_ln_P(data, invert) oled_write(data, invert)
 
 #    define oled_write_raw_P(data, size) oled_write_raw(data, size)
+
+#    define oled_draw_bitmap_P(x, y, bitmap, width, height) oled_draw_bitmap(x, y, bitmap, width, height)
 #endif  // defined(__AVR__)
 
 // Can be used to manually turn on the screen if it is off
@@ -0,0 +1,205 @@
+/* Copyright 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <functional>
+#include <random>
+#include <stdio.h>
+#include <string.h>
+
+extern "C" {
+#include "oled_driver.h"
+
+extern uint8_t         oled_buffer[OLED_MATRIX_SIZE];
+extern OLED_BLOCK_TYPE oled_dirty;
+extern uint8_t         oled_rotation_width;
+}
+
+namespace {
+// Per pixel versions of the primitives, which they have to match
+void reference_fill_rect(int x, int y, int width, int height, bool on) {
+    for (int i = x; i < x + width && i <= UINT8_MAX; i++) {
+        for (int j = y; j < y + height && j <= UINT8_MAX; j++) {
+            oled_write_pixel(i, j, on);
+        }
+    }
+}
+
+void reference_invert_rect(int x, int y, int width, int height) {
+    int rotation_height = OLED_MATRIX_SIZE / oled_rotation_width * 8;
+    for (int i = x; i < x + width && i < oled_rotation_width; i++) {
+        for (int j = y; j < y + height && j < rotation_height; j++) {
+            bool on = oled_buffer[i + j / 8 * oled_rotation_width] & (1 << (j % 8));
+            oled_write_pixel(i, j, !on);
+        }
+    }
+}
+
+void reference_draw_rect(int x, int y, int width, int height, bool on) {
+    if (!width || !height) return;
+    reference_fill_rect(x, y, width, 1, on);
+    reference_fill_rect(x, y + height - 1, width, 1, on);
+    reference_fill_rect(x, y, 1, height, on);
+    reference_fill_rect(x + width - 1, y, 1, height, on);
+}
+
+void reference_draw_line(int x0, int y0, int x1, int y1, bool on) {
+    int dx  = abs(x1 - x0);
+    int dy  = -abs(y1 - y0);
+    int sx  = x0 < x1 ? 1 : -1;
+    int sy  = y0 < y1 ? 1 : -1;
+    int err = dx + dy;
+    while (true) {
+        oled_write_pixel(x0, y0, on);
+        if (x0 == x1 && y0 == y1) break;
+        int e2 = 2 * err;
+        if (e2 >= dy) {
+            err += dy;
+            x0 += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y0 += sy;
+        }
+    }
+}
+
+void reference_draw_bitmap(int x, int y, const uint8_t* bitmap, int width, int height) {
+    int rotation_height = OLED_MATRIX_SIZE / oled_rotation_width * 8;
+    for (int i = 0; i < width; i++) {
+        for (int j = 0; j < height; j++) {
+            if (x + i < 0 || y + j < 0 || x + i >= oled_rotation_width || y + j >= rotation_height) continue;
+            oled_write_pixel(x + i, y + j, bitmap[j / 8 * width + i] & (1 << (j % 8)));
+        }
+    }
+}
+
+class OledDraw : public ::testing::TestWithParam<oled_rotation_t> {
+   protected:
+    void SetUp() override {
+        oled_init(GetParam());
+        rotation_height = OLED_MATRIX_SIZE / oled_rotation_width * 8;
+        for (auto& data : initial) {
+            data = rng();
+        }
+    }
+
+    // Runs both versions from the same random buffer, and checks that they
+    // leave the same buffer and dirty blocks behind
+    void compare(std::function<void()> reference, std::function<void()> primitive) {
+        memcpy(oled_buffer, initial, sizeof(initial));
+        oled_dirty = 0;
+        reference();
+        uint8_t         expected[OLED_MATRIX_SIZE];
+        OLED_BLOCK_TYPE expected_dirty = oled_dirty;
+        memcpy(expected, oled_buffer, sizeof(expected));
+
+        memcpy(oled_buffer, initial, sizeof(initial));
+        oled_dirty = 0;
+        primitive();
+        ASSERT_EQ(memcmp(expected, oled_buffer, sizeof(expected)), 0);
+        ASSERT_EQ(expected_dirty, oled_dirty);
+    }
+
+    // Times a batch of draws each way and reports the speedup
+    void bench(const char* name, std::function<void(uint32_t)> reference, std::function<void(uint32_t)> primitive) {
+        const uint32_t iterations = 20000;
+        auto           time       = [&](std::function<void(uint32_t)> draw) {
+            auto start = std::chrono::steady_clock::now();
+            for (uint32_t i = 0; i < iterations; i++) {
+                draw(i);
+            }
+            return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        };
+        double reference_us = time(reference);
+        double primitive_us = time(primitive);
+        printf("%-12s per pixel %8.0fus, primitive %8.0fus, %5.1fx\n", name, reference_us, primitive_us, reference_us / primitive_us);
+    }
+
+    uint8_t random_coordinate(int limit) { return std::uniform_int_distribution<int>(0, limit)(rng); }
+
+    std::mt19937 rng{1234};
+    uint8_t      initial[OLED_MATRIX_SIZE];
+    int          rotation_height;
+};
+}  // namespace
+
+TEST_P(OledDraw, Lines) {
+    for (int n = 0; n < 2000; n++) {
+        uint8_t x0 = random_coordinate(oled_rotation_width + 8);
+        uint8_t y0 = random_coordinate(rotation_height + 8);
+        uint8_t x1 = n % 4 == 0 ? x0 : random_coordinate(oled_rotation_width + 8);
+        uint8_t y1 = n % 4 == 1 ? y0 : random_coordinate(rotation_height + 8);
+        bool    on = n & 1;
+        compare([=] { reference_draw_line(x0, y0, x1, y1, on); }, [=] { oled_draw_line(x0, y0, x1, y1, on); });
+        compare([=] { reference_fill_rect(x0, y0, x1, 1, on); }, [=] { oled_draw_hline(x0, y0, x1, on); });
+        compare([=] { reference_fill_rect(x0, y0, 1, y1, on); }, [=] { oled_draw_vline(x0, y0, y1, on); });
+    }
+}
+
+TEST_P(OledDraw, Rectangles) {
+    for (int n = 0; n < 2000; n++) {
+        uint8_t x      = random_coordinate(oled_rotation_width + 8);
+        uint8_t y      = random_coordinate(rotation_height + 8);
+        uint8_t width  = random_coordinate(UINT8_MAX);
+        uint8_t height = random_coordinate(n % 2 ? 20 : UINT8_MAX);
+        bool    on     = n & 2;
+        compare([=] { reference_fill_rect(x, y, width, height, on); }, [=] { oled_fill_rect(x, y, width, height, on); });
+        compare([=] { reference_invert_rect(x, y, width, height); }, [=] { oled_invert_rect(x, y, width, height); });
+        compare([=] { reference_draw_rect(x, y, width, height, on); }, [=] { oled_draw_rect(x, y, width, height, on); });
+    }
+}
+
+TEST_P(OledDraw, Bitmaps) {
+    uint8_t bitmap[UINT8_MAX * 8];
+    for (auto& data : bitmap) {
+        data = rng();
+    }
+    for (int n = 0; n < 2000; n++) {
+        uint8_t width  = 1 + random_coordinate(63);
+        uint8_t height = 1 + random_coordinate(63);
+        int16_t x      = (int)random_coordinate(oled_rotation_width + 2 * width) - width;
+        int16_t y      = (int)random_coordinate(rotation_height + 2 * height) - height;
+        compare([&] { reference_draw_bitmap(x, y, bitmap, width, height); }, [&] { oled_draw_bitmap(x, y, bitmap, width, height); });
+    }
+}
+
+TEST_P(OledDraw, Speedup) {
+    uint8_t sprite[32 * 3];
+    for (auto& data : sprite) {
+        data = rng();
+    }
+    int w = oled_rotation_width;
+    int h = rotation_height;
+
+    // Bars of a volume or WPM meter
+    bench(
+        "bars", [&](uint32_t i) { reference_fill_rect(i % w, 0, 4, i % h, i & 1); }, [&](uint32_t i) { oled_fill_rect(i % w, 0, 4, i % h, i & 1); });
+    bench(
+        "hline", [&](uint32_t i) { reference_fill_rect(0, i % h, w, 1, i & 1); }, [&](uint32_t i) { oled_draw_hline(0, i % h, w, i & 1); });
+    bench(
+        "vline", [&](uint32_t i) { reference_fill_rect(i % w, 0, 1, h, i & 1); }, [&](uint32_t i) { oled_draw_vline(i % w, 0, h, i & 1); });
+    bench(
+        "line", [&](uint32_t i) { reference_draw_line(0, i % h, w - 1, h - 1 - i % h, i & 1); }, [&](uint32_t i) { oled_draw_line(0, i % h, w - 1, h - 1 - i % h, i & 1); });
+    bench(
+        "invert", [&](uint32_t i) { reference_invert_rect(0, 0, w, h); }, [&](uint32_t i) { oled_invert_rect(0, 0, w, h); });
+    bench(
+        "sprite", [&](uint32_t i) { reference_draw_bitmap(i % w - 16, i % h - 12, sprite, 32, 24); }, [&](uint32_t i) { oled_draw_bitmap(i % w - 16, i % h - 12, sprite, 32, 24); });
+}
+
+INSTANTIATE_TEST_CASE_P(Rotations, OledDraw, ::testing::Values(OLED_ROTATION_0, OLED_ROTATION_90));
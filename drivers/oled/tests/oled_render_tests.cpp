@@ -0,0 +1,150 @@
+/* Copyright 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <random>
+
+extern "C" {
+#include "oled_driver.h"
+#include "oled_sim.h"
+
+extern uint8_t         oled_buffer[OLED_MATRIX_SIZE];
+extern OLED_BLOCK_TYPE oled_dirty;
+extern uint8_t         oled_rotation_width;
+}
+
+namespace {
+const int             block_count = sizeof(OLED_BLOCK_TYPE) * 8;
+const int             block_size  = OLED_MATRIX_SIZE / block_count;
+const OLED_BLOCK_TYPE all_blocks  = (OLED_BLOCK_TYPE)~(OLED_BLOCK_TYPE)0;
+
+class OledRender : public ::testing::TestWithParam<oled_rotation_t> {
+   protected:
+    void SetUp() override {
+        oled_init(GetParam());
+        oled_sim_reset();
+    }
+
+    // Renders until nothing is dirty, and returns the number of calls
+    int render_all() {
+        int renders = 0;
+        do {
+            oled_render();
+            renders++;
+        } while (oled_dirty && renders < 1000);
+        return renders;
+    }
+
+    void randomize_blocks(OLED_BLOCK_TYPE blocks) {
+        for (int block = 0; block < block_count; block++) {
+            if (blocks & ((OLED_BLOCK_TYPE)1 << block)) {
+                for (int i = 0; i < block_size; i++) {
+                    oled_buffer[block * block_size + i] = rng();
+                }
+            }
+        }
+        oled_dirty |= blocks;
+    }
+
+    // Compares every pixel of the panel with the buffer it was drawn from.
+    // In 90 degree mode the buffer holds a display turned anticlockwise.
+    ::testing::AssertionResult display_matches() {
+        for (int x = 0; x < OLED_DISPLAY_WIDTH; x++) {
+            for (int y = 0; y < OLED_DISPLAY_HEIGHT; y++) {
+                int  buffer_x = GetParam() == OLED_ROTATION_90 ? OLED_DISPLAY_HEIGHT - 1 - y : x;
+                int  buffer_y = GetParam() == OLED_ROTATION_90 ? x : y;
+                bool expected = oled_buffer[buffer_x + buffer_y / 8 * oled_rotation_width] & (1 << (buffer_y % 8));
+                if (oled_sim_pixel(x, y) != expected) {
+                    return ::testing::AssertionFailure() << "pixel " << x << "," << y << " is " << !expected;
+                }
+            }
+        }
+        return ::testing::AssertionSuccess();
+    }
+
+    std::mt19937 rng{1234};
+};
+}  // namespace
+
+TEST_P(OledRender, MatchesBuffer) {
+    int rotation_height = OLED_MATRIX_SIZE / oled_rotation_width * 8;
+    for (int round = 0; round < 200; round++) {
+        int pixels = round == 0 ? OLED_MATRIX_SIZE : rng() % 80;
+        for (int n = 0; n < pixels; n++) {
+            oled_write_pixel(rng() % oled_rotation_width, rng() % rotation_height, rng() & 1);
+        }
+        render_all();
+        ASSERT_TRUE(display_matches()) << "round " << round;
+    }
+}
+
+TEST_P(OledRender, FullScreenInOneBurst) {
+    randomize_blocks(all_blocks);
+#if (OLED_IC == OLED_IC_SH1106)
+    // Page Addressing Mode stops at the end of every page
+    const int bursts = OLED_DISPLAY_HEIGHT / 8;
+#else
+    const int bursts = 1;
+#endif
+    EXPECT_EQ(render_all(), bursts);
+    EXPECT_EQ(oled_sim_commands(), (uint32_t)bursts);
+    EXPECT_TRUE(display_matches());
+}
+
+TEST_P(OledRender, MergesAdjacentDirtyBlocks) {
+    render_all();
+    uint32_t commands = oled_sim_commands();
+
+    // A run of three blocks, and one more further on
+    OLED_BLOCK_TYPE run = (OLED_BLOCK_TYPE)0x0E;
+    randomize_blocks(run | (OLED_BLOCK_TYPE)0x40);
+    oled_render();
+#if (OLED_IC == OLED_IC_SH1106)
+    // The run is cut where its first page ends
+    int page_end = (block_size / OLED_DISPLAY_WIDTH + 1) * OLED_DISPLAY_WIDTH / block_size;
+    if (page_end < 4) {
+        run &= ((OLED_BLOCK_TYPE)1 << page_end) - 1;
+    }
+#endif
+    EXPECT_EQ(oled_dirty, (OLED_BLOCK_TYPE)(0x4E & ~run));
+    EXPECT_EQ(oled_sim_commands() - commands, 1u);
+
+    render_all();
+    EXPECT_TRUE(display_matches());
+}
+
+TEST_P(OledRender, RedrawsAfterQueuedFailure) {
+    randomize_blocks(all_blocks);
+    render_all();
+    uint32_t clean_data = oled_sim_data();
+
+    // The dropped transfer is only noticed by the next render, which then
+    // has to send everything again
+    randomize_blocks(all_blocks);
+    oled_sim_fail_next();
+    render_all();
+    render_all();
+    EXPECT_GT(oled_sim_data() - clean_data, clean_data);
+    EXPECT_TRUE(display_matches());
+}
+
+#if (OLED_IC == OLED_IC_SH1106)
+// Rotated blocks span several pages, which Page Addressing Mode can't send
+INSTANTIATE_TEST_CASE_P(Rotations, OledRender, ::testing::Values(OLED_ROTATION_0));
+#else
+INSTANTIATE_TEST_CASE_P(Rotations, OledRender, ::testing::Values(OLED_ROTATION_0, OLED_ROTATION_90));
+#endif
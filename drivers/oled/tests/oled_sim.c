@@ -0,0 +1,158 @@
+/* Copyright 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "oled_sim.h"
+#include "i2c_master.h"
+#include "oled_driver.h"
+
+#include <string.h>
+
+// Both ICs have up to 8 pages; the SH1106 has 132 columns of RAM
+#define SIM_PAGES 8
+#define SIM_COLUMNS 132
+
+static uint8_t  sim_ram[SIM_PAGES][SIM_COLUMNS];
+static uint8_t  sim_column, sim_page;
+static uint8_t  sim_column_start, sim_column_end = OLED_DISPLAY_WIDTH - 1;
+static uint8_t  sim_page_start, sim_page_end = SIM_PAGES - 1;
+static uint32_t sim_commands, sim_data;
+static bool     sim_fail_next, sim_failed;
+
+void oled_sim_reset(void) {
+    memset(sim_ram, 0, sizeof(sim_ram));
+    sim_column = sim_page = 0;
+    sim_column_start = sim_page_start = 0;
+    sim_column_end                    = OLED_DISPLAY_WIDTH - 1;
+    sim_page_end                      = SIM_PAGES - 1;
+    sim_commands = sim_data = 0;
+    sim_fail_next = sim_failed = false;
+}
+
+bool oled_sim_pixel(uint8_t x, uint8_t y) {
+#if (OLED_IC == OLED_IC_SH1106)
+    x += OLED_COLUMN_OFFSET;
+#endif
+    return sim_ram[y / 8][x] & (1 << (y % 8));
+}
+
+uint32_t oled_sim_commands(void) { return sim_commands; }
+
+uint32_t oled_sim_data(void) { return sim_data; }
+
+void oled_sim_fail_next(void) { sim_fail_next = true; }
+
+static void sim_write_data(uint8_t data) {
+#if (OLED_IC == OLED_IC_SH1106)
+    // The column stops at the end of the page
+    if (sim_column < SIM_COLUMNS) {
+        sim_ram[sim_page][sim_column++] = data;
+    }
+#else
+    sim_ram[sim_page][sim_column] = data;
+    if (++sim_column > sim_column_end) {
+        sim_column = sim_column_start;
+        if (++sim_page > sim_page_end) {
+            sim_page = sim_page_start;
+        }
+    }
+#endif
+}
+
+// Number of argument bytes that follow a command
+static uint8_t sim_arguments(uint8_t command) {
+    switch (command) {
+        case 0x26:  // Scroll right
+        case 0x27:  // Scroll left
+            return 6;
+        case 0x29:  // Scroll right and up
+        case 0x2A:  // Scroll left and up
+            return 5;
+        case 0x21:  // Column address
+        case 0x22:  // Page address
+        case 0xA3:  // Vertical scroll area
+            return 2;
+        case 0x20:  // Memory mode
+        case 0x23:  // Fade and blink
+        case 0x81:  // Contrast
+        case 0x8D:  // Charge pump
+        case 0xA8:  // Multiplex ratio
+        case 0xD3:  // Display offset
+        case 0xD5:  // Display clock
+        case 0xD9:  // Pre-charge period
+        case 0xDA:  // COM pins
+        case 0xDB:  // VCOM detect
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+static void sim_run_commands(const uint8_t *data, uint16_t length) {
+    for (uint16_t i = 0; i < length; i += 1 + sim_arguments(data[i])) {
+        uint8_t command = data[i];
+#if (OLED_IC == OLED_IC_SH1106)
+        if ((command & 0xF8) == 0xB0) {
+            sim_page = command & 0x07;
+        } else if (command < 0x10) {
+            sim_column = (sim_column & 0xF0) | command;
+        } else if (command < 0x20) {
+            sim_column = (sim_column & 0x0F) | (command & 0x0F) << 4;
+        }
+#else
+        if (command == 0x21 && i + 2 < length) {
+            sim_column = sim_column_start = data[i + 1];
+            sim_column_end                = data[i + 2];
+        } else if (command == 0x22 && i + 2 < length) {
+            sim_page = sim_page_start = data[i + 1];
+            sim_page_end              = data[i + 2];
+        }
+#endif
+    }
+}
+
+static i2c_status_t sim_transfer(uint8_t control, const uint8_t *data, uint16_t length) {
+    if (control == 0x00) {
+        sim_commands++;
+        sim_run_commands(data, length);
+    } else {
+        sim_data++;
+        if (sim_fail_next) {
+            sim_fail_next = false;
+            sim_failed    = true;
+            return I2C_STATUS_SUCCESS;
+        }
+        for (uint16_t i = 0; i < length; i++) {
+            sim_write_data(data[i]);
+        }
+    }
+    return I2C_STATUS_SUCCESS;
+}
+
+void i2c_init(void) {}
+
+i2c_status_t i2c_transmit(uint8_t address, const uint8_t *data, uint16_t length, uint16_t timeout) { return length ? sim_transfer(data[0], &data[1], length - 1) : I2C_STATUS_ERROR; }
+
+i2c_status_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t *data, uint16_t length, uint16_t timeout) { return sim_transfer(regaddr, data, length); }
+
+i2c_status_t i2c_transmit_async(uint8_t address, const uint8_t *data, uint16_t length, uint16_t timeout) { return i2c_transmit(address, data, length, timeout); }
+
+i2c_status_t i2c_writeReg_async(uint8_t devaddr, uint8_t regaddr, const uint8_t *data, uint16_t length, uint16_t timeout) { return i2c_writeReg(devaddr, regaddr, data, length, timeout); }
+
+i2c_status_t i2c_async_status(uint8_t address) {
+    i2c_status_t result = sim_failed ? I2C_STATUS_ERROR : I2C_STATUS_SUCCESS;
+    sim_failed          = false;
+    return result;
+}
@@ -0,0 +1,39 @@
+/* Copyright 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// A display controller on the other end of the I2C stand in. It follows the
+// addressing commands of the IC selected by OLED_IC, Horizontal Addressing
+// Mode on the SSD1306 and Page Addressing Mode on the SH1106, and keeps the
+// display RAM they write to.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Clears the display RAM, the addressing state and the counters
+void oled_sim_reset(void);
+
+// Whether the pixel in column x and row y of the panel is lit
+bool oled_sim_pixel(uint8_t x, uint8_t y);
+
+// Number of command and data transfers since the last reset
+uint32_t oled_sim_commands(void);
+uint32_t oled_sim_data(void);
+
+// Drops the next data transfer, and reports it as failed through
+// i2c_async_status() like a queued transfer would be
+void oled_sim_fail_next(void);
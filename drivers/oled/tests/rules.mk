@@ -0,0 +1,33 @@
+oled_draw_128x32_DEFS := -DNO_DEBUG -DNO_PRINT -DOLED_DRIVER_ENABLE
+oled_draw_128x32_INC := $(DRIVER_PATH)/oled/tests $(DRIVER_PATH)/oled
+
+oled_draw_128x32_SRC := \
+	$(DRIVER_PATH)/oled/tests/oled_draw_tests.cpp \
+	$(DRIVER_PATH)/oled/tests/oled_sim.c \
+	$(DRIVER_PATH)/oled/oled_driver.c \
+	$(TMK_PATH)/common/test/timer.c
+
+oled_draw_128x64_DEFS := $(oled_draw_128x32_DEFS) -DOLED_DISPLAY_128X64
+oled_draw_128x64_INC := $(oled_draw_128x32_INC)
+oled_draw_128x64_SRC := $(oled_draw_128x32_SRC)
+
+oled_render_ssd1306_128x32_DEFS := $(oled_draw_128x32_DEFS)
+oled_render_ssd1306_128x32_INC := $(oled_draw_128x32_INC)
+
+oled_render_ssd1306_128x32_SRC := \
+	$(DRIVER_PATH)/oled/tests/oled_render_tests.cpp \
+	$(DRIVER_PATH)/oled/tests/oled_sim.c \
+	$(DRIVER_PATH)/oled/oled_driver.c \
+	$(TMK_PATH)/common/test/timer.c
+
+oled_render_ssd1306_128x64_DEFS := $(oled_render_ssd1306_128x32_DEFS) -DOLED_DISPLAY_128X64
+oled_render_ssd1306_128x64_INC := $(oled_render_ssd1306_128x32_INC)
+oled_render_ssd1306_128x64_SRC := $(oled_render_ssd1306_128x32_SRC)
+
+oled_render_sh1106_128x32_DEFS := $(oled_render_ssd1306_128x32_DEFS) -DOLED_IC=OLED_IC_SH1106
+oled_render_sh1106_128x32_INC := $(oled_render_ssd1306_128x32_INC)
+oled_render_sh1106_128x32_SRC := $(oled_render_ssd1306_128x32_SRC)
+
+oled_render_sh1106_128x64_DEFS := $(oled_render_ssd1306_128x32_DEFS) -DOLED_IC=OLED_IC_SH1106 -DOLED_DISPLAY_128X64
+oled_render_sh1106_128x64_INC := $(oled_render_ssd1306_128x32_INC)
+oled_render_sh1106_128x64_SRC := $(oled_render_ssd1306_128x32_SRC)
@@ -0,0 +1,7 @@
+TEST_LIST +=\
+	oled_draw_128x32\
+	oled_draw_128x64\
+	oled_render_ssd1306_128x32\
+	oled_render_ssd1306_128x64\
+	oled_render_sh1106_128x32\
+	oled_render_sh1106_128x64
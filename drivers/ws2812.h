@@ -16,6 +16,7 @@
 #pragma once
 
 #include "quantum/color.h"
+#include "progmem.h"
 
 /*
  * Older WS2812s can handle a reset time (TRST) of 50us, but recent
@@ -38,3 +39,25 @@
  *         - Wait 50us to reset the LEDs
  */
 void ws2812_setleds(LED_TYPE *ledarray, uint16_t number_of_leds);
+
+/* Same as ws2812_setleds(), but LED i is sent from ledarray[led_map[i]], with
+ * led_map read through pgm_read_byte(). A NULL led_map sends the LEDs in order.
+ * With RGBW, the white channel is worked out as each LED is encoded, so
+ * ledarray is left untouched.
+ */
+void ws2812_setleds_mapped(LED_TYPE *ledarray, const uint8_t *led_map, uint16_t number_of_leds);
+
+// Fetches LED i the way ws2812_setleds_mapped() sends it
+static inline LED_TYPE ws2812_mapped_led(LED_TYPE *ledarray, const uint8_t *led_map, uint16_t i) {
+    LED_TYPE color = ledarray[led_map ? pgm_read_byte(&led_map[i]) : i];
+#ifdef RGBW
+    convert_rgb_to_rgbw(&color);
+#endif
+    return color;
+}
+
+/* Returns true once the colors passed to the last ws2812_setleds() call
+ * have been sent out in full. Drivers that send asynchronously return
+ * from ws2812_setleds() straight away, the others always return true.
+ */
+bool ws2812_flush_complete(void);
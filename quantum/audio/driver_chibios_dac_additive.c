@@ -16,6 +16,7 @@
  */
 
 #include "audio.h"
+#include "wavetable.h"
 #include <ch.h>
 #include <hal.h>
 
@@ -81,11 +82,22 @@ static const dacsample_t dac_buffer_trapezoid[AUDIO_DAC_BUFFER_SIZE] = {0x0,   0
 
 static dacsample_t dac_buffer_empty[AUDIO_DAC_BUFFER_SIZE] = {AUDIO_DAC_OFF_VALUE};
 
-/* keep track of the sample position for for each frequency */
-static float dac_if[AUDIO_MAX_SIMULTANEOUS_TONES] = {0.0};
+#if defined(AUDIO_DAC_SAMPLE_WAVEFORM_SINE)
+static const dacsample_t *dac_wavetable = dac_buffer_sine;
+#elif defined(AUDIO_DAC_SAMPLE_WAVEFORM_TRIANGLE)
+static const dacsample_t *dac_wavetable = dac_buffer_triangle;
+#elif defined(AUDIO_DAC_SAMPLE_WAVEFORM_TRAPEZOID)
+static const dacsample_t *dac_wavetable = dac_buffer_trapezoid;
+#elif defined(AUDIO_DAC_SAMPLE_WAVEFORM_SQUARE)
+static const dacsample_t *dac_wavetable = dac_buffer_square;
+#endif
+
+_Static_assert(AUDIO_DAC_BUFFER_SIZE == WAVETABLE_SIZE, "The DAC sample tables have to match WAVETABLE_SIZE");
+_Static_assert(AUDIO_MAX_SIMULTANEOUS_TONES <= WAVETABLE_MAX_VOICES, "AUDIO_MAX_SIMULTANEOUS_TONES is too high for the additive DAC driver");
 
-static float   active_tones_snapshot[AUDIO_MAX_SIMULTANEOUS_TONES] = {0, 0};
-static uint8_t active_tones_snapshot_length                        = 0;
+/* keep track of the sample position and step for each frequency */
+static wavetable_voice_t dac_voices[AUDIO_MAX_SIMULTANEOUS_TONES] = {{0}};
+static uint8_t           active_tones_snapshot_length             = 0;
 
 typedef enum {
     OUTPUT_SHOULD_START,
@@ -107,7 +119,7 @@ output_states_t state = OUTPUT_OFF_2;
  * Generation of the waveform being passed to the callback. Declared weak so users
  * can override it with their own wave-forms/noises.
  */
-__attribute__((weak)) uint16_t dac_value_generate(void) {
+uint16_t dac_value_generate_default(void) {
     // DAC is running/asking for values but snapshot length is zero -> must be playing a pause
     if (active_tones_snapshot_length == 0) {
         return AUDIO_DAC_OFF_VALUE;
@@ -116,49 +128,26 @@ __attribute__((weak)) uint16_t dac_value_generate(void) {
     /* doing additive wave synthesis over all currently playing tones = adding up
      * sine-wave-samples for each frequency, scaled by the number of active tones
      */
-    uint16_t value     = 0;
-    float    frequency = 0.0f;
-
-    for (uint8_t i = 0; i < active_tones_snapshot_length; i++) {
-        /* Note: a user implementation does not have to rely on the active_tones_snapshot, but
-         * could directly query the active frequencies through audio_get_processed_frequency */
-        frequency = active_tones_snapshot[i];
-
-        dac_if[i] = dac_if[i] + ((frequency * AUDIO_DAC_BUFFER_SIZE) / AUDIO_DAC_SAMPLE_RATE) * 2 / 3;
-        /*Note: the 2/3 are necessary to get the correct frequencies on the
-         *      DAC output (as measured with an oscilloscope), since the gpt
-         *      timer runs with 3*AUDIO_DAC_SAMPLE_RATE; and the DAC callback
-         *      is called twice per conversion.*/
-
-        dac_if[i] = fmod(dac_if[i], AUDIO_DAC_BUFFER_SIZE);
-
-        // Wavetable generation/lookup
-        uint16_t dac_i = (uint16_t)dac_if[i];
+    return wavetable_sample(dac_wavetable, dac_voices, active_tones_snapshot_length);
+}
+uint16_t dac_value_generate(void) __attribute__((weak, alias("dac_value_generate_default")));
 
-#if defined(AUDIO_DAC_SAMPLE_WAVEFORM_SINE)
-        value += dac_buffer_sine[dac_i] / active_tones_snapshot_length;
-#elif defined(AUDIO_DAC_SAMPLE_WAVEFORM_TRIANGLE)
-        value += dac_buffer_triangle[dac_i] / active_tones_snapshot_length;
-#elif defined(AUDIO_DAC_SAMPLE_WAVEFORM_TRAPEZOID)
-        value += dac_buffer_trapezoid[dac_i] / active_tones_snapshot_length;
-#elif defined(AUDIO_DAC_SAMPLE_WAVEFORM_SQUARE)
-        value += dac_buffer_square[dac_i] / active_tones_snapshot_length;
-#endif
-        /*
-        // SINE
-        value += dac_buffer_sine[dac_i] / active_tones_snapshot_length / 3;
-        // TRIANGLE
-        value += dac_buffer_triangle[dac_i] / active_tones_snapshot_length / 3;
-        // SQUARE
-        value += dac_buffer_square[dac_i] / active_tones_snapshot_length / 3;
-        //NOTE: combination of these three wave-forms is more exemplary - and doesn't sound particularly good :-P
-        */
-
-        // STAIRS (mostly usefully as test-pattern)
-        // value_avg = dac_buffer_staircase[dac_i] / active_tones_snapshot_length;
+/**
+ * Fills a stretch of the buffer with the current tones, a voice at a time
+ * unless a user implementation of dac_value_generate needs to be called per sample.
+ */
+static void dac_render(dacsample_t *sample_p, uint16_t length) {
+    if (dac_value_generate != dac_value_generate_default) {
+        for (uint16_t s = 0; s < length; s++) {
+            sample_p[s] = dac_value_generate();
+        }
+    } else if (active_tones_snapshot_length == 0) {
+        for (uint16_t s = 0; s < length; s++) {
+            sample_p[s] = AUDIO_DAC_OFF_VALUE;
+        }
+    } else {
+        wavetable_render(sample_p, length, dac_wavetable, dac_voices, active_tones_snapshot_length);
     }
-
-    return value;
 }
 
 /**
@@ -178,6 +167,10 @@ static void dac_end(DACDriver *dacp) {
         if (OUTPUT_OFF <= state) {
             sample_p[s] = AUDIO_DAC_OFF_VALUE;
             continue;
+        } else if (OUTPUT_RUN_NORMALLY == state) {
+            // the tones only change between buffers, so the rest is rendered in one go
+            dac_render(&sample_p[s], AUDIO_DAC_BUFFER_SIZE / 2 - s);
+            break;
         } else {
             sample_p[s] = dac_value_generate();
         }
@@ -221,7 +214,11 @@ static void dac_end(DACDriver *dacp) {
             for (uint8_t i = 0; i < active_tones; i++) {
                 float freq = audio_get_processed_frequency(i);
                 if (freq > 0) {  // disregard 'rest' notes, with valid frequency 0.0f; which would only lower the resulting waveform volume during the additive synthesis step
-                    active_tones_snapshot[active_tones_snapshot_length++] = freq;
+                    /*Note: the 2/3 are necessary to get the correct frequencies on the
+                     *      DAC output (as measured with an oscilloscope), since the gpt
+                     *      timer runs with 3*AUDIO_DAC_SAMPLE_RATE; and the DAC callback
+                     *      is called twice per conversion.*/
+                    dac_voices[active_tones_snapshot_length++].step = wavetable_phase_step(freq, AUDIO_DAC_SAMPLE_RATE * 3 / 2.0f);
                 }
             }
 
@@ -327,8 +324,8 @@ void audio_driver_start(void) {
     gptStartContinuous(&GPTD6, 2U);
 
     for (uint8_t i = 0; i < AUDIO_MAX_SIMULTANEOUS_TONES; i++) {
-        dac_if[i]                = 0.0f;
-        active_tones_snapshot[i] = 0.0f;
+        dac_voices[i].phase = 0;
+        dac_voices[i].step  = 0;
     }
     active_tones_snapshot_length = 0;
     state                        = OUTPUT_SHOULD_START;
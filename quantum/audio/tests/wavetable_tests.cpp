@@ -0,0 +1,183 @@
+/* Copyright 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <stdio.h>
+#include <stdlib.h>
+#if defined(__x86_64__) || defined(__i386__)
+#    include <x86intrin.h>
+#endif
+
+extern "C" {
+#include "wavetable.h"
+}
+
+namespace {
+// The additive DAC driver plays its tables at 1.5 times AUDIO_DAC_SAMPLE_RATE,
+// and fills half of its 256 sample buffer per callback
+const float    sample_rate = 44100 * 3 / 2.0f;
+const uint16_t half_buffer = 128;
+
+// A chord spread over the range of the music keycodes
+const float chord[] = {261.63f, 329.63f, 392.00f, 523.25f, 880.00f, 1318.51f, 2093.00f, 4186.01f, 65.41f, 7902.13f, 146.83f, 587.33f};
+
+class Wavetable : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        // A 12bit sine, starting at its lowest point like the driver's
+        for (int i = 0; i < WAVETABLE_SIZE; i++) {
+            table[i] = lround(2047.5 * (1 - cos(2 * M_PI * i / WAVETABLE_SIZE)));
+        }
+        for (int i = 0; i < WAVETABLE_SIZE; i++) {
+            max_slope = std::max(max_slope, abs(table[(i + 1) % WAVETABLE_SIZE] - table[i]));
+        }
+    }
+
+    void start(wavetable_voice_t* voices, uint8_t count) {
+        for (uint8_t i = 0; i < count; i++) {
+            voices[i].phase = 0;
+            voices[i].step  = wavetable_phase_step(chord[i], sample_rate);
+        }
+    }
+
+    uint16_t table[WAVETABLE_SIZE];
+    int      max_slope = 0;
+};
+
+// The float version the driver used before, with the 2/3 folded into the rate
+struct Legacy {
+    float    position[WAVETABLE_MAX_VOICES] = {0};
+    uint16_t value(const uint16_t* table, uint8_t count) {
+        uint16_t value = 0;
+        for (uint8_t i = 0; i < count; i++) {
+            position[i] = position[i] + (chord[i] * WAVETABLE_SIZE) / sample_rate;
+            position[i] = fmod(position[i], WAVETABLE_SIZE);
+            value += table[(uint16_t)position[i]] / count;
+        }
+        return value;
+    }
+};
+
+uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// Time taken per half buffer, in cycles where the counter is available
+double per_buffer(std::function<void(uint16_t*)> render) {
+    const int buffers = 20000;
+    uint16_t  samples[half_buffer];
+    uint64_t  start = now();
+    for (int n = 0; n < buffers; n++) {
+        render(samples);
+    }
+    uint64_t end = now();
+    // Keeps the renders from being optimized out
+    volatile uint16_t sink = samples[half_buffer - 1];
+    (void)sink;
+    return (double)(end - start) / buffers;
+}
+}  // namespace
+
+TEST_F(Wavetable, PhaseStep) {
+    // A full turn of the phase is one period of the table
+    EXPECT_NEAR(wavetable_phase_step(440.0f, sample_rate) / 4294967296.0, 440.0 / sample_rate, 1e-7);
+    EXPECT_EQ(wavetable_phase_step(0.0f, sample_rate), 0u);
+    // Tones above the sample rate alias, as they did with fmod()
+    EXPECT_EQ(wavetable_phase_step(sample_rate + 440.0f, sample_rate) >> 12, wavetable_phase_step(440.0f, sample_rate) >> 12);
+}
+
+// Rendering a buffer at once has to give the same samples as one at a time
+TEST_F(Wavetable, RenderMatchesSample) {
+    for (uint8_t count = 1; count <= 12; count++) {
+        wavetable_voice_t rendered[WAVETABLE_MAX_VOICES];
+        wavetable_voice_t sampled[WAVETABLE_MAX_VOICES];
+        start(rendered, count);
+        start(sampled, count);
+        for (int buffer = 0; buffer < 50; buffer++) {
+            uint16_t samples[half_buffer];
+            wavetable_render(samples, half_buffer, table, rendered, count);
+            for (uint16_t s = 0; s < half_buffer; s++) {
+                ASSERT_EQ(samples[s], wavetable_sample(table, sampled, count)) << (int)count << " voices, buffer " << buffer << " sample " << s;
+            }
+        }
+        for (uint8_t i = 0; i < count; i++) {
+            EXPECT_EQ(rendered[i].phase, sampled[i].phase);
+        }
+    }
+}
+
+// Compares a second of rendered buffers with exact phases and averages
+TEST_F(Wavetable, MatchesReference) {
+    for (uint8_t count = 1; count <= 12; count++) {
+        wavetable_voice_t voices[WAVETABLE_MAX_VOICES];
+        double            phase[WAVETABLE_MAX_VOICES] = {0};
+        start(voices, count);
+
+        int total = 0, exact = 0, close = 0, worst = 0;
+        for (int buffer = 0; buffer < 500; buffer++) {
+            uint16_t samples[half_buffer];
+            wavetable_render(samples, half_buffer, table, voices, count);
+            for (uint16_t s = 0; s < half_buffer; s++) {
+                double sum = 0;
+                for (uint8_t i = 0; i < count; i++) {
+                    // Starting from the same float ratio the firmware computes
+                    phase[i] += (double)(chord[i] / sample_rate);
+                    phase[i] -= floor(phase[i]);
+                    sum += table[(int)(phase[i] * WAVETABLE_SIZE)];
+                }
+                int difference = abs(samples[s] - (int)(sum / count));
+                total++;
+                exact += difference == 0;
+                close += difference <= 1;
+                worst = std::max(worst, difference);
+            }
+        }
+        // The phases only drift off by a fraction of an entry, so a sample
+        // can at most be off by a step of the table
+        EXPECT_GE(close, total * 99 / 100) << (int)count << " voices";
+        EXPECT_LE(worst, max_slope) << (int)count << " voices";
+        printf("%2d voices: %5.1f%% exact, %5.1f%% within 1, worst %d\n", count, 100.0 * exact / total, 100.0 * close / total, worst);
+    }
+}
+
+TEST_F(Wavetable, Speedup) {
+    for (uint8_t count : {1, 2, 4, 8, 12}) {
+        wavetable_voice_t voices[WAVETABLE_MAX_VOICES];
+        Legacy            legacy;
+        start(voices, count);
+
+        double legacy_time = per_buffer([&](uint16_t* samples) {
+            for (uint16_t s = 0; s < half_buffer; s++) {
+                samples[s] = legacy.value(table, count);
+            }
+        });
+        double wavetable_time = per_buffer([&](uint16_t* samples) { wavetable_render(samples, half_buffer, table, voices, count); });
+#if defined(__x86_64__) || defined(__i386__)
+        const char* unit = "cycles";
+#else
+        const char* unit = "ns";
+#endif
+        printf("%2d voices: float %8.0f, fixed-point %6.0f %s per buffer, %5.1fx\n", count, legacy_time, wavetable_time, unit, legacy_time / wavetable_time);
+    }
+}
@@ -0,0 +1,67 @@
+/* Copyright 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "wavetable.h"
+
+uint32_t wavetable_phase_step(float frequency, float sample_rate) {
+    float periods = frequency / sample_rate;
+    periods -= (uint32_t)periods;
+    // Scaling by a power of two is exact, and keeps the result below 2^32
+    return (uint32_t)(periods * 4294967296.0f);
+}
+
+// Dividing by the number of voices, as a multiplication by its rounded up reciprocal
+static inline uint32_t wavetable_gain(uint8_t count) { return (0x10000 + count - 1) / count; }
+
+uint16_t wavetable_sample(const uint16_t *table, wavetable_voice_t *voices, uint8_t count) {
+    uint16_t sum = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        voices[i].phase += voices[i].step;
+        sum += table[voices[i].phase >> WAVETABLE_PHASE_SHIFT];
+    }
+    return (sum * wavetable_gain(count)) >> 16;
+}
+
+void wavetable_render(uint16_t *samples, uint16_t length, const uint16_t *table, wavetable_voice_t *voices, uint8_t count) {
+    if (!count) {
+        return;
+    }
+
+    // One voice at a time, so its phase and step stay in registers
+    for (uint8_t i = 0; i < count; i++) {
+        uint32_t phase = voices[i].phase;
+        uint32_t step  = voices[i].step;
+        if (i == 0) {
+            for (uint16_t s = 0; s < length; s++) {
+                phase += step;
+                samples[s] = table[phase >> WAVETABLE_PHASE_SHIFT];
+            }
+        } else {
+            for (uint16_t s = 0; s < length; s++) {
+                phase += step;
+                samples[s] += table[phase >> WAVETABLE_PHASE_SHIFT];
+            }
+        }
+        voices[i].phase = phase;
+    }
+
+    if (count > 1) {
+        uint32_t gain = wavetable_gain(count);
+        for (uint16_t s = 0; s < length; s++) {
+            samples[s] = (samples[s] * gain) >> 16;
+        }
+    }
+}
@@ -0,0 +1,59 @@
+/* Copyright 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Fixed-point wavetable synthesis, used by the additive DAC driver.
+ *
+ * Every voice keeps a 32bit phase, where a full turn is one period of the
+ * WAVETABLE_SIZE entry table, and the top bits pick the entry. The float
+ * math is all in wavetable_phase_step(), which only runs when a tone
+ * changes; rendering is integer adds and table lookups, at the same cost
+ * for every voice.
+ */
+
+#define WAVETABLE_SIZE 256
+#define WAVETABLE_PHASE_SHIFT 24
+
+// Voices are summed in 16 bits, so with 12bit samples up to 16 can be mixed
+#define WAVETABLE_MAX_VOICES 16
+
+typedef struct {
+    uint32_t phase;
+    uint32_t step;
+} wavetable_voice_t;
+
+/**
+ * @brief phase increment per sample for a tone
+ *
+ * @param[in] frequency of the tone, in Hz
+ * @param[in] sample_rate the table is played back at
+ */
+uint32_t wavetable_phase_step(float frequency, float sample_rate);
+
+/**
+ * @brief advances the voices by one sample, and returns their average
+ */
+uint16_t wavetable_sample(const uint16_t *table, wavetable_voice_t *voices, uint8_t count);
+
+/**
+ * @brief renders length samples of the averaged voices, the same as calling
+ * wavetable_sample() for each of them
+ */
+void wavetable_render(uint16_t *samples, uint16_t length, const uint16_t *table, wavetable_voice_t *voices, uint8_t count);
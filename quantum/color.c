@@ -106,6 +106,93 @@ RGB hsv_to_rgb(HSV hsv) {
 
 RGB hsv_to_rgb_nocie(HSV hsv) { return hsv_to_rgb_impl(hsv, false); }
 
+// Converts count HSV values in one pass, producing exactly what hsv_to_rgb()
+// would for each. The hue/saturation dependent factors are only recomputed
+// when they change, so runs of LEDs sharing a hue (solid colors, reactive
+// and breathing effects) cost three multiplies each.
+void hsv_to_rgb_span(const HSV *hsv, RGB *rgb, uint8_t count) {
+    bool     have_factors = false;
+    uint8_t  last_h = 0, last_s = 0, region = 0;
+    uint16_t fp = 0, fq = 0, ft = 0;
+
+    for (uint8_t i = 0; i < count; i++) {
+        HSV      in = hsv[i];
+        uint16_t v;
+        uint8_t  p, q, t;
+
+#ifdef USE_CIE1931_CURVE
+        v = pgm_read_byte(&CIE1931_CURVE[in.v]);
+#else
+        v = in.v;
+#endif
+
+        if (in.s == 0) {
+            rgb[i].r = rgb[i].g = rgb[i].b = v;
+            continue;
+        }
+
+        if (!have_factors || in.h != last_h || in.s != last_s) {
+            uint16_t s = in.s;
+            uint8_t  remainder;
+
+            region    = in.h * 6 / 255;
+            remainder = (in.h * 2 - region * 85) * 3;
+
+            fp           = 255 - s;
+            fq           = 255 - ((s * remainder) >> 8);
+            ft           = 255 - ((s * (255 - remainder)) >> 8);
+            last_h       = in.h;
+            last_s       = in.s;
+            have_factors = true;
+        }
+
+#if defined(__AVR__)
+        p = (v * fp) >> 8;
+        q = (v * fq) >> 8;
+#else
+        // Both products fit in 16 bits, so they can share one 32-bit multiply.
+        uint32_t pq = v * (fp | ((uint32_t)fq << 16));
+        p           = pq >> 8;
+        q           = pq >> 24;
+#endif
+        t = (v * ft) >> 8;
+
+        switch (region) {
+            case 6:
+            case 0:
+                rgb[i].r = v;
+                rgb[i].g = t;
+                rgb[i].b = p;
+                break;
+            case 1:
+                rgb[i].r = q;
+                rgb[i].g = v;
+                rgb[i].b = p;
+                break;
+            case 2:
+                rgb[i].r = p;
+                rgb[i].g = v;
+                rgb[i].b = t;
+                break;
+            case 3:
+                rgb[i].r = p;
+                rgb[i].g = q;
+                rgb[i].b = v;
+                break;
+            case 4:
+                rgb[i].r = t;
+                rgb[i].g = p;
+                rgb[i].b = v;
+                break;
+            default:
+                rgb[i].r = v;
+                rgb[i].g = p;
+                rgb[i].b = q;
+                break;
+        }
+    }
+}
+
 #ifdef RGBW
 #    ifndef MIN
 #        define MIN(a, b) ((a) < (b) ? (a) : (b))
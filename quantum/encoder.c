@@ -23,6 +23,14 @@
 // for memcpy
 #include <string.h>
 
+#if defined(ENCODER_SAMPLE_TIMER) || defined(ENCODER_SAMPLE_EDGES)
+#    define ENCODER_SAMPLING
+#endif
+
+#ifdef ENCODER_SAMPLING
+#    include "atomic_util.h"
+#endif
+
 #if !defined(ENCODER_RESOLUTIONS) && !defined(ENCODER_RESOLUTION)
 #    define ENCODER_RESOLUTION 4
 #endif
@@ -49,6 +57,10 @@ static int8_t encoder_LUT[] = {0, -1, 1, 0, 1, 0, 0, -1, -1, 0, 0, 1, 0, 1, -1,
 
 static uint8_t encoder_state[NUMBER_OF_ENCODERS]  = {0};
 static int8_t  encoder_pulses[NUMBER_OF_ENCODERS] = {0};
+#ifdef ENCODER_SAMPLING
+// Pulses decoded by encoder_sample() that encoder_read() hasn't consumed yet
+static volatile int16_t encoder_pending[NUMBER_OF_ENCODERS] = {0};
+#endif
 
 #ifdef SPLIT_KEYBOARD
 // right half encoders come over as second set of encoders
@@ -63,6 +75,58 @@ __attribute__((weak)) bool encoder_update_user(uint8_t index, bool clockwise) {
 
 __attribute__((weak)) bool encoder_update_kb(uint8_t index, bool clockwise) { return encoder_update_user(index, clockwise); }
 
+#ifdef ENCODER_SAMPLING
+void encoder_sample(uint8_t index) {
+    uint8_t state          = (encoder_state[index] << 2) | (readPin(encoders_pad_a[index]) << 0) | (readPin(encoders_pad_b[index]) << 1);
+    encoder_state[index]   = state;
+    encoder_pending[index] += encoder_LUT[state & 0xF];
+}
+
+void encoder_sample_all(void) {
+    for (uint8_t i = 0; i < NUMBER_OF_ENCODERS; i++) {
+        encoder_sample(i);
+    }
+}
+#endif
+
+#if defined(ENCODER_SAMPLE_EDGES) && defined(PROTOCOL_CHIBIOS)
+#    if !PAL_USE_CALLBACKS
+#        error "You need to set PAL_USE_CALLBACKS to TRUE in your halconf.h to use ENCODER_SAMPLE_EDGES."
+#    endif
+
+static void encoder_edge_cb(void *arg) { encoder_sample((uintptr_t)arg); }
+
+static void encoder_sampling_start(void) {
+    for (uint8_t i = 0; i < NUMBER_OF_ENCODERS; i++) {
+        palEnableLineEvent(encoders_pad_a[i], PAL_EVENT_MODE_BOTH_EDGES);
+        palSetLineCallback(encoders_pad_a[i], encoder_edge_cb, (void *)(uintptr_t)i);
+        palEnableLineEvent(encoders_pad_b[i], PAL_EVENT_MODE_BOTH_EDGES);
+        palSetLineCallback(encoders_pad_b[i], encoder_edge_cb, (void *)(uintptr_t)i);
+    }
+}
+#elif defined(ENCODER_SAMPLE_TIMER) && defined(PROTOCOL_CHIBIOS)
+#    ifndef ENCODER_SAMPLE_INTERVAL
+#        define ENCODER_SAMPLE_INTERVAL 250
+#    endif
+
+static virtual_timer_t encoder_timer;
+
+static void encoder_timer_cb(void *arg) {
+    encoder_sample_all();
+    chSysLockFromISR();
+    chVTSetI(&encoder_timer, TIME_US2I(ENCODER_SAMPLE_INTERVAL), encoder_timer_cb, NULL);
+    chSysUnlockFromISR();
+}
+
+static void encoder_sampling_start(void) {
+    chVTObjectInit(&encoder_timer);
+    chVTSet(&encoder_timer, TIME_US2I(ENCODER_SAMPLE_INTERVAL), encoder_timer_cb, NULL);
+}
+#elif defined(ENCODER_SAMPLING)
+// Elsewhere the keyboard calls encoder_sample() from its own interrupts
+static void encoder_sampling_start(void) {}
+#endif
+
 void encoder_init(void) {
 #if defined(SPLIT_KEYBOARD) && defined(ENCODERS_PAD_A_RIGHT) && defined(ENCODERS_PAD_B_RIGHT)
     if (!isLeftHand) {
@@ -92,9 +156,13 @@ void encoder_init(void) {
     thisHand = isLeftHand ? 0 : NUMBER_OF_ENCODERS;
     thatHand = NUMBER_OF_ENCODERS - thisHand;
 #endif
+
+#ifdef ENCODER_SAMPLING
+    encoder_sampling_start();
+#endif
 }
 
-static bool encoder_update(uint8_t index, uint8_t state) {
+static bool encoder_update(uint8_t index, int16_t pulses) {
     bool    changed = false;
     uint8_t i       = index;
 
@@ -107,27 +175,38 @@ static bool encoder_update(uint8_t index, uint8_t state) {
 #ifdef SPLIT_KEYBOARD
     index += thisHand;
 #endif
-    encoder_pulses[i] += encoder_LUT[state & 0xF];
-    if (encoder_pulses[i] >= resolution) {
+    pulses += encoder_pulses[i];
+    while (pulses >= resolution) {
+        pulses -= resolution;
         encoder_value[index]++;
         changed = true;
         encoder_update_kb(index, ENCODER_COUNTER_CLOCKWISE);
     }
-    if (encoder_pulses[i] <= -resolution) {  // direction is arbitrary here, but this clockwise
+    while (pulses <= -resolution) {  // direction is arbitrary here, but this clockwise
+        pulses += resolution;
         encoder_value[index]--;
         changed = true;
         encoder_update_kb(index, ENCODER_CLOCKWISE);
     }
-    encoder_pulses[i] %= resolution;
+    encoder_pulses[i] = pulses;
     return changed;
 }
 
 bool encoder_read(void) {
     bool changed = false;
     for (uint8_t i = 0; i < NUMBER_OF_ENCODERS; i++) {
+#ifdef ENCODER_SAMPLING
+        int16_t pulses;
+        ATOMIC_BLOCK_FORCEON {
+            pulses             = encoder_pending[i];
+            encoder_pending[i] = 0;
+        }
+        changed |= encoder_update(i, pulses);
+#else
         encoder_state[i] <<= 2;
         encoder_state[i] |= (readPin(encoders_pad_a[i]) << 0) | (readPin(encoders_pad_b[i]) << 1);
-        changed |= encoder_update(i, encoder_state[i]);
+        changed |= encoder_update(i, encoder_LUT[encoder_state[i] & 0xF]);
+#endif
     }
     return changed;
 }
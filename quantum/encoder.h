@@ -25,6 +25,13 @@ bool encoder_read(void);
 bool encoder_update_kb(uint8_t index, bool clockwise);
 bool encoder_update_user(uint8_t index, bool clockwise);
 
+#if defined(ENCODER_SAMPLING) || defined(ENCODER_SAMPLE_TIMER) || defined(ENCODER_SAMPLE_EDGES)
+// Decodes the current pin state of an encoder into pulses for the next
+// encoder_read(), safe to call from interrupts
+void encoder_sample(uint8_t index);
+void encoder_sample_all(void);
+#endif
+
 #ifdef SPLIT_KEYBOARD
 void encoder_state_raw(uint8_t* slave_state);
 void encoder_update_raw(uint8_t* slave_state);
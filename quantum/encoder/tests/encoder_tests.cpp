@@ -0,0 +1,147 @@
+/* Copyright 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <vector>
+
+extern "C" {
+#include "encoder.h"
+
+bool mock_pins[4];
+
+static int steps[2];
+
+bool encoder_update_user(uint8_t index, bool clockwise) {
+    steps[index] += clockwise ? 1 : -1;
+    return true;
+}
+}
+
+namespace {
+struct Edge {
+    uint32_t time;
+    uint8_t  encoder;
+    uint8_t  pin;
+};
+
+// Turns an encoder by detents, one edge every interval microseconds. Going
+// clockwise toggles pad A first at every detent, and a bounce adds a short
+// glitch on the pin before each real edge.
+uint32_t spin(std::vector<Edge>& edges, uint8_t encoder, uint32_t time, int detents, uint32_t interval, bool bounce) {
+    uint8_t first = detents > 0 ? 0 : 1;
+    for (int n = 0; n < abs(detents) * 4; n++) {
+        uint8_t pin = encoder * 2 + (first ^ (n & 1));
+        if (bounce) {
+            edges.push_back({time, encoder, pin});
+            edges.push_back({time + 3, encoder, pin});
+            time += 6;
+        }
+        edges.push_back({time, encoder, pin});
+        time += interval;
+    }
+    return time;
+}
+
+enum Sampling { EDGES, TIMER, POLLED };
+
+const uint32_t timer_interval = 250;
+
+class EncoderSampling : public ::testing::TestWithParam<uint32_t> {
+   protected:
+    void SetUp() override {
+        encoder_init();
+        encoder_read();
+        steps[0] = steps[1] = 0;
+    }
+
+    // Plays the edges back in time order, with the main loop calling
+    // encoder_read() every loop_interval microseconds
+    void run(std::vector<Edge> edges, Sampling sampling) {
+        std::stable_sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) { return a.time < b.time; });
+        uint32_t loop_interval = GetParam();
+        size_t   next          = 0;
+        for (uint32_t time = 0; next < edges.size(); time++) {
+            for (; next < edges.size() && edges[next].time == time; next++) {
+                mock_pins[edges[next].pin] = !mock_pins[edges[next].pin];
+                if (sampling == EDGES) {
+                    encoder_sample(edges[next].encoder);
+                }
+            }
+            if (sampling == TIMER && time % timer_interval == 0) {
+                encoder_sample_all();
+            }
+            if (time % loop_interval == 0) {
+                // Without interrupts the pins are only seen by the main loop
+                if (sampling == POLLED) {
+                    encoder_sample_all();
+                }
+                encoder_read();
+            }
+        }
+        if (sampling != EDGES) {
+            encoder_sample_all();
+        }
+        encoder_read();
+    }
+};
+}  // namespace
+
+TEST_P(EncoderSampling, FastSpins) {
+    std::vector<Edge> edges;
+    uint32_t          end = spin(edges, 0, 1, 40, 600, false);
+    spin(edges, 0, end, -25, 400, false);
+    end = spin(edges, 1, 7, -30, 900, false);
+    spin(edges, 1, end, 12, 300, false);
+
+    for (Sampling sampling : {EDGES, TIMER}) {
+        steps[0] = steps[1] = 0;
+        run(edges, sampling);
+        EXPECT_EQ(steps[0], 15) << "sampling " << sampling;
+        EXPECT_EQ(steps[1], -18) << "sampling " << sampling;
+    }
+
+    steps[0] = steps[1] = 0;
+    run(edges, POLLED);
+    printf("loop every %6uus: polling saw %d and %d of 15 and -18 steps\n", GetParam(), steps[0], steps[1]);
+}
+
+TEST_P(EncoderSampling, BouncingEdges) {
+    std::vector<Edge> edges;
+    uint32_t          end = spin(edges, 0, 1, 20, 700, true);
+    spin(edges, 0, end, -8, 700, true);
+    spin(edges, 1, 3, -16, 500, true);
+
+    // Every glitch undoes itself, so only the edges decide the count
+    run(edges, EDGES);
+    EXPECT_EQ(steps[0], 12);
+    EXPECT_EQ(steps[1], -16);
+}
+
+// Spins that outlast a stalled loop many times over still add up
+TEST_P(EncoderSampling, LongStalls) {
+    std::vector<Edge> edges;
+    spin(edges, 0, 1, 300, 260, false);
+    spin(edges, 1, 1, -300, 260, false);
+
+    run(edges, TIMER);
+    EXPECT_EQ(steps[0], 300);
+    EXPECT_EQ(steps[1], -300);
+}
+
+INSTANTIATE_TEST_CASE_P(LoopIntervals, EncoderSampling, ::testing::Values(1000, 10000, 50000, 200000));
@@ -0,0 +1,29 @@
+/* Copyright 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Simulated pins for the encoder tests
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef uint8_t pin_t;
+
+extern bool mock_pins[];
+
+#define setPinInputHigh(pin) (mock_pins[pin] = true)
+#define readPin(pin) mock_pins[pin]
@@ -0,0 +1,7 @@
+encoder_sampling_DEFS := -DNO_DEBUG -DNO_PRINT -DENCODER_ENABLE -DENCODER_SAMPLING -DIGNORE_ATOMIC_BLOCK
+encoder_sampling_INC := $(QUANTUM_PATH)/encoder/tests
+encoder_sampling_CONFIG := $(QUANTUM_PATH)/encoder/tests/config.h
+
+encoder_sampling_SRC := \
+	$(QUANTUM_PATH)/encoder/tests/encoder_tests.cpp \
+	$(QUANTUM_PATH)/encoder.c
@@ -127,9 +127,9 @@ static last_hit_t last_hit_buffer;
 const uint8_t k_led_matrix_split[2] = LED_MATRIX_SPLIT;
 #endif
 
-void eeconfig_read_led_matrix(void) { eeprom_read_block(&led_matrix_eeconfig, EECONFIG_LED_MATRIX, sizeof(led_matrix_eeconfig)); }
+void eeconfig_read_led_matrix(void) { eeconfig_read_block(&led_matrix_eeconfig, EECONFIG_LED_MATRIX, sizeof(led_matrix_eeconfig)); }
 
-void eeconfig_update_led_matrix(void) { eeprom_update_block(&led_matrix_eeconfig, EECONFIG_LED_MATRIX, sizeof(led_matrix_eeconfig)); }
+void eeconfig_update_led_matrix(void) { eeconfig_update_block(&led_matrix_eeconfig, EECONFIG_LED_MATRIX, sizeof(led_matrix_eeconfig)); }
 
 void eeconfig_update_led_matrix_default(void) {
     dprintf("eeconfig_update_led_matrix_default\n");
@@ -154,12 +154,7 @@ __attribute__((weak)) uint8_t led_matrix_map_row_column_to_led_kb(uint8_t row, u
 
 uint8_t led_matrix_map_row_column_to_led(uint8_t row, uint8_t column, uint8_t *led_i) {
     uint8_t led_count = led_matrix_map_row_column_to_led_kb(row, column, led_i);
-    uint8_t led_index = g_led_config.matrix_co[row][column];
-    if (led_index != NO_LED) {
-        led_i[led_count] = led_index;
-        led_count++;
-    }
-    return led_count;
+    return lighting_map_row_column_to_led(row, column, led_i, led_count);
 }
 
 void led_matrix_update_pwm_buffers(void) { led_matrix_driver.flush(); }
@@ -214,22 +209,7 @@ void process_led_matrix(uint8_t row, uint8_t col, bool pressed) {
         led_count = led_matrix_map_row_column_to_led(row, col, led);
     }
 
-    if (last_hit_buffer.count + led_count > LED_HITS_TO_REMEMBER) {
-        memcpy(&last_hit_buffer.x[0], &last_hit_buffer.x[led_count], LED_HITS_TO_REMEMBER - led_count);
-        memcpy(&last_hit_buffer.y[0], &last_hit_buffer.y[led_count], LED_HITS_TO_REMEMBER - led_count);
-        memcpy(&last_hit_buffer.tick[0], &last_hit_buffer.tick[led_count], (LED_HITS_TO_REMEMBER - led_count) * 2);  // 16 bit
-        memcpy(&last_hit_buffer.index[0], &last_hit_buffer.index[led_count], LED_HITS_TO_REMEMBER - led_count);
-        last_hit_buffer.count--;
-    }
-
-    for (uint8_t i = 0; i < led_count; i++) {
-        uint8_t index                = last_hit_buffer.count;
-        last_hit_buffer.x[index]     = g_led_config.point[led[i]].x;
-        last_hit_buffer.y[index]     = g_led_config.point[led[i]].y;
-        last_hit_buffer.index[index] = led[i];
-        last_hit_buffer.tick[index]  = 0;
-        last_hit_buffer.count++;
-    }
+    lighting_hits_push(&last_hit_buffer, led, led_count);
 #endif  // LED_MATRIX_KEYREACTIVE_ENABLED
 
 #if defined(LED_MATRIX_FRAMEBUFFER_EFFECTS) && !defined(DISABLE_LED_MATRIX_TYPING_HEATMAP)
@@ -256,25 +236,12 @@ static void led_task_timers(void) {
 
     // Update double buffer timers
 #if LED_DISABLE_TIMEOUT > 0
-    if (led_anykey_timer < UINT32_MAX) {
-        if (UINT32_MAX - deltaTime < led_anykey_timer) {
-            led_anykey_timer = UINT32_MAX;
-        } else {
-            led_anykey_timer += deltaTime;
-        }
-    }
+    lighting_timer_add(&led_anykey_timer, deltaTime);
 #endif  // LED_DISABLE_TIMEOUT > 0
 
     // Update double buffer last hit timers
 #ifdef LED_MATRIX_KEYREACTIVE_ENABLED
-    uint8_t count = last_hit_buffer.count;
-    for (uint8_t i = 0; i < count; ++i) {
-        if (UINT16_MAX - deltaTime < last_hit_buffer.tick[i]) {
-            last_hit_buffer.count--;
-            continue;
-        }
-        last_hit_buffer.tick[i] += deltaTime;
-    }
+    lighting_hits_age(&last_hit_buffer, deltaTime);
 #endif  // LED_MATRIX_KEYREACTIVE_ENABLED
 }
 
@@ -430,15 +397,8 @@ void led_matrix_init(void) {
     led_matrix_driver.init();
 
 #ifdef LED_MATRIX_KEYREACTIVE_ENABLED
-    g_last_hit_tracker.count = 0;
-    for (uint8_t i = 0; i < LED_HITS_TO_REMEMBER; ++i) {
-        g_last_hit_tracker.tick[i] = UINT16_MAX;
-    }
-
-    last_hit_buffer.count = 0;
-    for (uint8_t i = 0; i < LED_HITS_TO_REMEMBER; ++i) {
-        last_hit_buffer.tick[i] = UINT16_MAX;
-    }
+    lighting_hits_clear(&g_last_hit_tracker);
+    lighting_hits_clear(&last_hit_buffer);
 #endif  // LED_MATRIX_KEYREACTIVE_ENABLED
 
     if (!eeconfig_is_enabled()) {
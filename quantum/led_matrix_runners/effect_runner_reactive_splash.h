@@ -4,14 +4,18 @@
 
 typedef uint8_t (*reactive_splash_f)(uint8_t val, int16_t dx, int16_t dy, uint8_t dist, uint16_t tick);
 
-bool effect_runner_reactive_splash(uint8_t start, effect_params_t* params, reactive_splash_f effect_func) {
+bool effect_runner_reactive_splash_reach(uint8_t start, effect_params_t* params, reactive_splash_f effect_func, lighting_splash_reach_f reach_func) {
     LED_MATRIX_USE_LIMITS(led_min, led_max);
 
-    uint8_t count = g_last_hit_tracker.count;
+    if (params->iter == 0) lighting_splash_index(&g_last_hit_tracker, led_matrix_eeconfig.speed, start, reach_func);
+
     for (uint8_t i = led_min; i < led_max; i++) {
         LED_MATRIX_TEST_LED_FLAGS();
         uint8_t val = 0;
-        for (uint8_t j = start; j < count; j++) {
+
+        lighting_splash_mask_t hits = g_lighting_splash_grid[LIGHTING_SPLASH_BUCKET(g_led_config.point[i].x, g_led_config.point[i].y)];
+        for (uint8_t j = 0; hits; j++, hits >>= 1) {
+            if (!(hits & 1)) continue;
             int16_t  dx   = g_led_config.point[i].x - g_last_hit_tracker.x[j];
             int16_t  dy   = g_led_config.point[i].y - g_last_hit_tracker.y[j];
             uint8_t  dist = sqrt16(dx * dx + dy * dy);
@@ -23,4 +27,7 @@ bool effect_runner_reactive_splash(uint8_t start, effect_params_t* params, react
     return led_max < DRIVER_LED_TOTAL;
 }
 
+// Without a reach function every hit is checked against every LED
+bool effect_runner_reactive_splash(uint8_t start, effect_params_t* params, reactive_splash_f effect_func) { return effect_runner_reactive_splash_reach(start, params, effect_func, NULL); }
+
 #endif  // LED_MATRIX_KEYREACTIVE_ENABLED
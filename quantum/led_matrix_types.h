@@ -18,12 +18,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
-
-#if defined(__GNUC__)
-#    define PACKED __attribute__((__packed__))
-#else
-#    define PACKED
-#endif
+#include "lighting_core.h"
 
 #if defined(_MSC_VER)
 #    pragma pack(push, 1)
@@ -33,52 +28,7 @@
 #    define LED_MATRIX_KEYREACTIVE_ENABLED
 #endif
 
-// Last led hit
-#ifndef LED_HITS_TO_REMEMBER
-#    define LED_HITS_TO_REMEMBER 8
-#endif  // LED_HITS_TO_REMEMBER
-
-#ifdef LED_MATRIX_KEYREACTIVE_ENABLED
-typedef struct PACKED {
-    uint8_t  count;
-    uint8_t  x[LED_HITS_TO_REMEMBER];
-    uint8_t  y[LED_HITS_TO_REMEMBER];
-    uint8_t  index[LED_HITS_TO_REMEMBER];
-    uint16_t tick[LED_HITS_TO_REMEMBER];
-} last_hit_t;
-#endif  // LED_MATRIX_KEYREACTIVE_ENABLED
-
-typedef enum led_task_states { STARTING, RENDERING, FLUSHING, SYNCING } led_task_states;
-
-typedef uint8_t led_flags_t;
-
-typedef struct PACKED {
-    uint8_t     iter;
-    led_flags_t flags;
-    bool        init;
-} effect_params_t;
-
-typedef struct PACKED {
-    uint8_t x;
-    uint8_t y;
-} led_point_t;
-
-#define HAS_FLAGS(bits, flags) ((bits & flags) == flags)
-#define HAS_ANY_FLAGS(bits, flags) ((bits & flags) != 0x00)
-
-#define LED_FLAG_ALL 0xFF
-#define LED_FLAG_NONE 0x00
-#define LED_FLAG_MODIFIER 0x01
-#define LED_FLAG_KEYLIGHT 0x04
-#define LED_FLAG_INDICATOR 0x08
-
-#define NO_LED 255
-
-typedef struct PACKED {
-    uint8_t     matrix_co[MATRIX_ROWS][MATRIX_COLS];
-    led_point_t point[DRIVER_LED_TOTAL];
-    uint8_t     flags[DRIVER_LED_TOTAL];
-} led_config_t;
+typedef lighting_task_states led_task_states;
 
 typedef union {
     uint32_t raw;
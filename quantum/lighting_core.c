@@ -0,0 +1,159 @@
+/* Copyright 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+#include "lighting_core.h"
+#include <string.h>
+
+#include <lib/lib8tion/lib8tion.h>
+
+uint8_t lighting_map_row_column_to_led(uint8_t row, uint8_t column, uint8_t *led_i, uint8_t led_count) {
+    uint8_t led_index = g_led_config.matrix_co[row][column];
+    if (led_index != NO_LED) {
+        led_i[led_count] = led_index;
+        led_count++;
+    }
+    return led_count;
+}
+
+void lighting_hits_clear(last_hit_t *hits) {
+    hits->count = 0;
+    for (uint8_t i = 0; i < LED_HITS_TO_REMEMBER; ++i) {
+        hits->tick[i] = UINT16_MAX;
+    }
+}
+
+void lighting_hits_push(last_hit_t *hits, const uint8_t *led, uint8_t led_count) {
+    if (led_count > LED_HITS_TO_REMEMBER) {
+        led += led_count - LED_HITS_TO_REMEMBER;
+        led_count = LED_HITS_TO_REMEMBER;
+    }
+
+    // Make room by dropping the oldest hits
+    if (hits->count + led_count > LED_HITS_TO_REMEMBER) {
+        uint8_t drop = hits->count + led_count - LED_HITS_TO_REMEMBER;
+        uint8_t keep = hits->count - drop;
+        memmove(&hits->x[0], &hits->x[drop], keep);
+        memmove(&hits->y[0], &hits->y[drop], keep);
+        memmove(&hits->tick[0], &hits->tick[drop], keep * sizeof(hits->tick[0]));
+        memmove(&hits->index[0], &hits->index[drop], keep);
+        hits->count = keep;
+    }
+
+    for (uint8_t i = 0; i < led_count; i++) {
+        uint8_t index      = hits->count;
+        hits->x[index]     = g_led_config.point[led[i]].x;
+        hits->y[index]     = g_led_config.point[led[i]].y;
+        hits->index[index] = led[i];
+        hits->tick[index]  = 0;
+        hits->count++;
+    }
+}
+
+void lighting_hits_age(last_hit_t *hits, uint32_t delta) {
+    uint8_t count = hits->count;
+    for (uint8_t i = 0; i < count; ++i) {
+        if (UINT16_MAX - delta < hits->tick[i]) {
+            hits->count--;
+            continue;
+        }
+        hits->tick[i] += delta;
+    }
+}
+
+void lighting_timer_add(uint32_t *timer, uint32_t delta) {
+    if (*timer < UINT32_MAX) {
+        if (UINT32_MAX - delta < *timer) {
+            *timer = UINT32_MAX;
+        } else {
+            *timer += delta;
+        }
+    }
+}
+
+lighting_splash_mask_t g_lighting_splash_grid[LIGHTING_SPLASH_GRID_COLS * LIGHTING_SPLASH_GRID_ROWS];
+
+// Splash style effects light a ring where tick - dist is below 255
+bool lighting_splash_ring_reach(uint16_t tick, uint8_t *inner, uint8_t *outer) {
+    if (tick > 254 + 255) return false;
+    *inner = tick > 254 ? tick - 254 : 0;
+    *outer = tick < 255 ? tick : 255;
+    return true;
+}
+
+// Nexus lines are a splash ring cut off past a distance of 72
+bool lighting_splash_nexus_reach(uint16_t tick, uint8_t *inner, uint8_t *outer) {
+    if (!lighting_splash_ring_reach(tick, inner, outer)) return false;
+    if (*outer > 72) *outer = 72;
+    return *inner <= *outer;
+}
+
+// Cross and wide effects fade with tick + dist, with dist weighted by 5 for wide
+bool lighting_splash_cross_reach(uint16_t tick, uint8_t *inner, uint8_t *outer) {
+    if (tick > 254) return false;
+    *outer = 254 - tick;
+    return true;
+}
+
+bool lighting_splash_wide_reach(uint16_t tick, uint8_t *inner, uint8_t *outer) {
+    if (tick > 254) return false;
+    *outer = (254 - tick) / 5;
+    return true;
+}
+
+// Squared distance along one axis from p to the nearest or farthest end of [lo, hi]
+static uint16_t lighting_splash_span_sq(uint8_t p, uint8_t lo, uint8_t hi, bool far) {
+    uint8_t to_lo = p > lo ? p - lo : lo - p;
+    uint8_t to_hi = p > hi ? p - hi : hi - p;
+    uint8_t d;
+    if (far) {
+        d = to_lo > to_hi ? to_lo : to_hi;
+    } else {
+        d = p < lo ? to_lo : p > hi ? to_hi : 0;
+    }
+    return (uint16_t)((uint16_t)d * d);
+}
+
+void lighting_splash_index(const last_hit_t *hits, uint8_t speed, uint8_t start, lighting_splash_reach_f reach_func) {
+    memset(g_lighting_splash_grid, 0, sizeof(g_lighting_splash_grid));
+
+    for (uint8_t j = start; j < hits->count; j++) {
+        lighting_splash_mask_t bit   = (lighting_splash_mask_t)1 << j;
+        uint8_t                inner = 0;
+        uint8_t                outer = 255;
+        if (reach_func && !reach_func(scale16by8(hits->tick[j], speed), &inner, &outer)) continue;
+
+        uint8_t hx = hits->x[j];
+        uint8_t hy = hits->y[j];
+        for (uint8_t row = 0; row < LIGHTING_SPLASH_GRID_ROWS; row++) {
+            uint8_t  y0     = row << 4;
+            uint8_t  y1     = row < LIGHTING_SPLASH_GRID_ROWS - 1 ? y0 + 15 : 255;
+            uint32_t near_y = lighting_splash_span_sq(hy, y0, y1, false);
+            uint32_t far_y  = lighting_splash_span_sq(hy, y0, y1, true);
+            for (uint8_t col = 0; col < LIGHTING_SPLASH_GRID_COLS; col++) {
+                uint8_t  x0       = col << 5;
+                uint8_t  x1       = x0 + 31;
+                uint32_t near_dsq = lighting_splash_span_sq(hx, x0, x1, false) + near_y;
+                uint32_t far_dsq  = lighting_splash_span_sq(hx, x0, x1, true) + far_y;
+                // Runners truncate the squared distance to 16 bits, so any
+                // bucket past that has to be checked LED by LED
+                if (far_dsq > UINT16_MAX || (near_dsq < (uint32_t)(outer + 1) * (outer + 1) && far_dsq >= (uint32_t)inner * inner)) {
+                    g_lighting_splash_grid[row * LIGHTING_SPLASH_GRID_COLS + col] |= bit;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,135 @@
+/* Copyright 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Types and helpers shared by led_matrix and rgb_matrix. Everything here is
+// independent of the pixel type, so both subsystems build on one copy.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#if defined(__GNUC__)
+#    define PACKED __attribute__((__packed__))
+#else
+#    define PACKED
+#endif
+
+#if defined(_MSC_VER)
+#    pragma pack(push, 1)
+#endif
+
+// Last led hit
+#ifndef LED_HITS_TO_REMEMBER
+#    define LED_HITS_TO_REMEMBER 8
+#endif  // LED_HITS_TO_REMEMBER
+
+typedef struct PACKED {
+    uint8_t  count;
+    uint8_t  x[LED_HITS_TO_REMEMBER];
+    uint8_t  y[LED_HITS_TO_REMEMBER];
+    uint8_t  index[LED_HITS_TO_REMEMBER];
+    uint16_t tick[LED_HITS_TO_REMEMBER];
+} last_hit_t;
+
+typedef enum lighting_task_states { STARTING, RENDERING, FLUSHING, SYNCING } lighting_task_states;
+
+typedef uint8_t led_flags_t;
+
+typedef struct PACKED {
+    uint8_t     iter;
+    led_flags_t flags;
+    bool        init;
+} effect_params_t;
+
+typedef struct PACKED {
+    uint8_t x;
+    uint8_t y;
+} led_point_t;
+
+#define HAS_FLAGS(bits, flags) ((bits & flags) == flags)
+#define HAS_ANY_FLAGS(bits, flags) ((bits & flags) != 0x00)
+
+#define LED_FLAG_ALL 0xFF
+#define LED_FLAG_NONE 0x00
+#define LED_FLAG_MODIFIER 0x01
+#define LED_FLAG_UNDERGLOW 0x02
+#define LED_FLAG_KEYLIGHT 0x04
+#define LED_FLAG_INDICATOR 0x08
+
+#define NO_LED 255
+
+typedef struct PACKED {
+    uint8_t     matrix_co[MATRIX_ROWS][MATRIX_COLS];
+    led_point_t point[DRIVER_LED_TOTAL];
+    uint8_t     flags[DRIVER_LED_TOTAL];
+} led_config_t;
+
+#if defined(_MSC_VER)
+#    pragma pack(pop)
+#endif
+
+extern led_config_t g_led_config;
+
+// Adds the LEDs under the matrix position at row, column to led_i, after
+// the extra ones the keyboard added there. Returns the total count.
+uint8_t lighting_map_row_column_to_led(uint8_t row, uint8_t column, uint8_t *led_i, uint8_t led_count);
+
+// Reactive effects keep the most recent LED_HITS_TO_REMEMBER key hits,
+// oldest first, with the time since each hit in tick.
+void lighting_hits_clear(last_hit_t *hits);
+void lighting_hits_push(last_hit_t *hits, const uint8_t *led, uint8_t led_count);
+void lighting_hits_age(last_hit_t *hits, uint32_t delta);
+
+// Adds delta to timer, stopping at UINT32_MAX
+void lighting_timer_add(uint32_t *timer, uint32_t delta);
+
+// Splash style effects only light LEDs near the wave of each hit. The LED
+// space is split into 32x16 buckets, with the last row also taking every LED
+// past y = 64, and lighting_splash_index() gives every bucket a mask of the
+// hits that can reach it, so LEDs only look at hits whose wave is nearby.
+#define LIGHTING_SPLASH_GRID_COLS 8
+#define LIGHTING_SPLASH_GRID_ROWS 5
+#define LIGHTING_SPLASH_BUCKET(x, y) (((y) < 64 ? (y) >> 4 : 4) * LIGHTING_SPLASH_GRID_COLS + ((x) >> 5))
+
+#if LED_HITS_TO_REMEMBER <= 8
+typedef uint8_t lighting_splash_mask_t;
+#elif LED_HITS_TO_REMEMBER <= 16
+typedef uint16_t lighting_splash_mask_t;
+#elif LED_HITS_TO_REMEMBER <= 32
+typedef uint32_t lighting_splash_mask_t;
+#elif LED_HITS_TO_REMEMBER <= 64
+typedef uint64_t lighting_splash_mask_t;
+#else
+#    error "LED_HITS_TO_REMEMBER must be 64 or less"
+#endif
+
+extern lighting_splash_mask_t g_lighting_splash_grid[LIGHTING_SPLASH_GRID_COLS * LIGHTING_SPLASH_GRID_ROWS];
+
+// Narrows down the distances a hit can still light at the given tick.
+// Returns false once the hit can't light anything.
+typedef bool (*lighting_splash_reach_f)(uint16_t tick, uint8_t *inner, uint8_t *outer);
+
+// Rebuilds g_lighting_splash_grid from the hits past start, with their ticks
+// scaled by speed. Without a reach function every hit is assumed to reach
+// everywhere.
+void lighting_splash_index(const last_hit_t *hits, uint8_t speed, uint8_t start, lighting_splash_reach_f reach_func);
+
+// Reach of the stock effects, which are the same for either pixel type
+bool lighting_splash_ring_reach(uint16_t tick, uint8_t *inner, uint8_t *outer);
+bool lighting_splash_nexus_reach(uint16_t tick, uint8_t *inner, uint8_t *outer);
+bool lighting_splash_cross_reach(uint16_t tick, uint8_t *inner, uint8_t *outer);
+bool lighting_splash_wide_reach(uint16_t tick, uint8_t *inner, uint8_t *outer);
@@ -73,6 +73,30 @@ void restorePinState(pin_t pin, uint16_t restoreState) {
 #endif
 }
 
+#if JOYSTICK_AXES_COUNT > 0
+static void process_joystick_update_axis(uint8_t axis_index, int16_t axis_val) {
+    // test the converted value against the lower range
+    int32_t ref        = joystick_axes[axis_index].mid_digit;
+    int32_t range      = joystick_axes[axis_index].min_digit;
+    int32_t ranged_val = ((axis_val - ref) * -JOYSTICK_RESOLUTION) / (range - ref);
+
+    if (ranged_val > 0) {
+        // the value is in the higher range
+        range      = joystick_axes[axis_index].max_digit;
+        ranged_val = ((axis_val - ref) * JOYSTICK_RESOLUTION) / (range - ref);
+    }
+
+    // clamp the result in the valid range
+    ranged_val = ranged_val < -JOYSTICK_RESOLUTION ? -JOYSTICK_RESOLUTION : ranged_val;
+    ranged_val = ranged_val > JOYSTICK_RESOLUTION ? JOYSTICK_RESOLUTION : ranged_val;
+
+    if (ranged_val != joystick_status.axes[axis_index]) {
+        joystick_status.axes[axis_index] = ranged_val;
+        joystick_status.status |= JS_UPDATED;
+    }
+}
+#endif
+
 __attribute__((weak)) bool process_joystick_analogread() { return process_joystick_analogread_quantum(); }
 
 bool process_joystick_analogread_quantum() {
@@ -82,6 +106,23 @@ bool process_joystick_analogread_quantum() {
             continue;
         }
 
+#    if defined(PROTOCOL_CHIBIOS) && defined(ADC_CONTINUOUS_PINS)
+        // Sampled in the background, so the axis stays powered and the read
+        // returns the latest filtered value right away
+        if (analogPinIsContinuous(joystick_axes[axis_index].input_pin)) {
+            if (joystick_axes[axis_index].output_pin != JS_VIRTUAL_AXIS) {
+                setPinOutput(joystick_axes[axis_index].output_pin);
+                writePinHigh(joystick_axes[axis_index].output_pin);
+            }
+            if (joystick_axes[axis_index].ground_pin != JS_VIRTUAL_AXIS) {
+                setPinOutput(joystick_axes[axis_index].ground_pin);
+                writePinLow(joystick_axes[axis_index].ground_pin);
+            }
+            process_joystick_update_axis(axis_index, analogReadPin(joystick_axes[axis_index].input_pin));
+            continue;
+        }
+#    endif
+
         // save previous input pin status as well
         uint16_t inputSavedState = savePinState(joystick_axes[axis_index].input_pin);
 
@@ -126,25 +167,7 @@ bool process_joystick_analogread_quantum() {
         int16_t axis_val = joystick_axes[axis_index].mid_digit;
 #    endif
 
-        // test the converted value against the lower range
-        int32_t ref        = joystick_axes[axis_index].mid_digit;
-        int32_t range      = joystick_axes[axis_index].min_digit;
-        int32_t ranged_val = ((axis_val - ref) * -JOYSTICK_RESOLUTION) / (range - ref);
-
-        if (ranged_val > 0) {
-            // the value is in the higher range
-            range      = joystick_axes[axis_index].max_digit;
-            ranged_val = ((axis_val - ref) * JOYSTICK_RESOLUTION) / (range - ref);
-        }
-
-        // clamp the result in the valid range
-        ranged_val = ranged_val < -JOYSTICK_RESOLUTION ? -JOYSTICK_RESOLUTION : ranged_val;
-        ranged_val = ranged_val > JOYSTICK_RESOLUTION ? JOYSTICK_RESOLUTION : ranged_val;
-
-        if (ranged_val != joystick_status.axes[axis_index]) {
-            joystick_status.axes[axis_index] = ranged_val;
-            joystick_status.status |= JS_UPDATED;
-        }
+        process_joystick_update_axis(axis_index, axis_val);
 
         // restore output, ground and input status
         if (joystick_axes[axis_index].output_pin != JS_VIRTUAL_AXIS) {
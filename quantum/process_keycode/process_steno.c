@@ -84,13 +84,13 @@ void steno_init() {
     if (!eeconfig_is_enabled()) {
         eeconfig_init();
     }
-    mode = eeprom_read_byte(EECONFIG_STENOMODE);
+    mode = eeconfig_read_byte(EECONFIG_STENOMODE);
 }
 
 void steno_set_mode(steno_mode_t new_mode) {
     steno_clear_state();
     mode = new_mode;
-    eeprom_update_byte(EECONFIG_STENOMODE, mode);
+    eeconfig_update_byte(EECONFIG_STENOMODE, mode);
 }
 
 /* override to intercept chords right before they get sent.
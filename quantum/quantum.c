@@ -140,6 +140,7 @@ void reset_keyboard(void) {
 #ifdef HAPTIC_ENABLE
     haptic_shutdown();
 #endif
+    eeconfig_flush();
     bootloader_jump();
 }
 
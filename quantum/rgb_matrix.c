@@ -31,11 +31,71 @@ const led_point_t k_rgb_matrix_center = {112, 32};
 const led_point_t k_rgb_matrix_center = RGB_MATRIX_CENTER;
 #endif
 
+static RGB rgb_matrix_hsv_to_rgb_default(HSV hsv) { return hsv_to_rgb(hsv); }
+
+#ifndef __APPLE__
+RGB rgb_matrix_hsv_to_rgb(HSV hsv) __attribute__((weak, alias("rgb_matrix_hsv_to_rgb_default")));
+#else
+// Mach-O has no aliases, so host builds there always convert per LED
 __attribute__((weak)) RGB rgb_matrix_hsv_to_rgb(HSV hsv) { return hsv_to_rgb(hsv); }
+#endif
+
+#ifndef RGB_MATRIX_SPAN_SIZE
+#    define RGB_MATRIX_SPAN_SIZE 16
+#endif
+
+// LEDs rendered by a runner are collected here and converted to RGB in
+// batches, so the HSV conversion runs as one tight loop per span.
+typedef struct {
+    uint8_t count;
+    uint8_t index[RGB_MATRIX_SPAN_SIZE];
+    HSV     hsv[RGB_MATRIX_SPAN_SIZE];
+} rgb_matrix_span_t;
+
+static void rgb_matrix_span_flush(rgb_matrix_span_t *span) {
+    RGB rgb[RGB_MATRIX_SPAN_SIZE];
+
+    // Only batch when the conversion hook hasn't been overridden
+    if (rgb_matrix_hsv_to_rgb == rgb_matrix_hsv_to_rgb_default) {
+        hsv_to_rgb_span(span->hsv, rgb, span->count);
+    } else {
+        for (uint8_t j = 0; j < span->count; j++) {
+            rgb[j] = rgb_matrix_hsv_to_rgb(span->hsv[j]);
+        }
+    }
+    for (uint8_t j = 0; j < span->count; j++) {
+        rgb_matrix_set_color(span->index[j], rgb[j].r, rgb[j].g, rgb[j].b);
+    }
+    span->count = 0;
+}
+
+static inline void rgb_matrix_span_push(rgb_matrix_span_t *span, uint8_t index, HSV hsv) {
+    span->index[span->count] = index;
+    span->hsv[span->count]   = hsv;
+    if (++span->count == RGB_MATRIX_SPAN_SIZE) {
+        rgb_matrix_span_flush(span);
+    }
+}
+
+// LED positions relative to the matrix center, for the effect runners
+#ifdef RGB_MATRIX_GEOMETRY_CACHE
+led_geometry_t g_led_geometry[DRIVER_LED_TOTAL];
+
+#    define RGB_MATRIX_LED_DX(i) (g_led_geometry[i].dx)
+#    define RGB_MATRIX_LED_DY(i) (g_led_geometry[i].dy)
+#    define RGB_MATRIX_LED_DIST(i) (g_led_geometry[i].dist)
+#    define RGB_MATRIX_LED_ANGLE(i) (g_led_geometry[i].angle)
+#else
+#    define RGB_MATRIX_LED_DX(i) ((int16_t)g_led_config.point[i].x - k_rgb_matrix_center.x)
+#    define RGB_MATRIX_LED_DY(i) ((int16_t)g_led_config.point[i].y - k_rgb_matrix_center.y)
+#    define RGB_MATRIX_LED_DIST(i) sqrt16(RGB_MATRIX_LED_DX(i) * RGB_MATRIX_LED_DX(i) + RGB_MATRIX_LED_DY(i) * RGB_MATRIX_LED_DY(i))
+#    define RGB_MATRIX_LED_ANGLE(i) atan2_8(RGB_MATRIX_LED_DY(i), RGB_MATRIX_LED_DX(i))
+#endif
 
 // Generic effect runners
 #include "rgb_matrix_runners/effect_runner_dx_dy_dist.h"
 #include "rgb_matrix_runners/effect_runner_dx_dy.h"
+#include "rgb_matrix_runners/effect_runner_dist_angle.h"
 #include "rgb_matrix_runners/effect_runner_i.h"
 #include "rgb_matrix_runners/effect_runner_sin_cos_i.h"
 #include "rgb_matrix_runners/effect_runner_reactive.h"
@@ -92,6 +152,18 @@ __attribute__((weak)) RGB rgb_matrix_hsv_to_rgb(HSV hsv) { return hsv_to_rgb(hsv
 #    define RGB_MATRIX_SPD_STEP 16
 #endif
 
+#ifdef RGB_MATRIX_FRAME_BUDGET_US
+#    ifndef RGB_MATRIX_TYPING_BUDGET_US
+#        define RGB_MATRIX_TYPING_BUDGET_US (RGB_MATRIX_FRAME_BUDGET_US / 4)
+#    endif
+#    ifndef RGB_MATRIX_TYPING_TIMEOUT
+#        define RGB_MATRIX_TYPING_TIMEOUT 500
+#    endif
+// Milliseconds of observed render time folded into each cost estimate
+#    define RGB_GOVERNOR_WINDOW 8
+#    define RGB_GOVERNOR_FLUSHES 16
+#endif
+
 #if !defined(RGB_MATRIX_STARTUP_MODE)
 #    ifndef DISABLE_RGB_MATRIX_CYCLE_LEFT_RIGHT
 #        define RGB_MATRIX_STARTUP_MODE RGB_MATRIX_CYCLE_LEFT_RIGHT
@@ -126,6 +198,10 @@ uint8_t g_rgb_frame_buffer[MATRIX_ROWS][MATRIX_COLS] = {{0}};
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
 last_hit_t g_last_hit_tracker;
 #endif  // RGB_MATRIX_KEYREACTIVE_ENABLED
+#ifdef RGB_MATRIX_FRAME_BUDGET_US
+uint8_t g_rgb_led_min;
+uint8_t g_rgb_led_max;
+#endif  // RGB_MATRIX_FRAME_BUDGET_US
 
 // internals
 static bool            suspend_state     = false;
@@ -136,6 +212,15 @@ static rgb_task_states rgb_task_state    = SYNCING;
 #if RGB_DISABLE_TIMEOUT > 0
 static uint32_t rgb_anykey_timer;
 #endif  // RGB_DISABLE_TIMEOUT > 0
+#ifdef RGB_MATRIX_FRAME_BUDGET_US
+static uint32_t rgb_led_cost = (RGB_MATRIX_FRAME_BUDGET_US * 256UL * 5) / DRIVER_LED_TOTAL;  // per LED, in 1/256 us
+static uint32_t rgb_flush_cost;                                                              // per flush, in us
+static uint32_t rgb_render_us;
+static uint16_t rgb_render_leds;
+static uint32_t rgb_flush_us;
+static uint8_t  rgb_flush_count;
+static uint32_t rgb_typing_timer;
+#endif  // RGB_MATRIX_FRAME_BUDGET_US
 
 // double buffers
 static uint32_t rgb_timer_buffer;
@@ -148,9 +233,9 @@ static last_hit_t last_hit_buffer;
 const uint8_t k_rgb_matrix_split[2] = RGB_MATRIX_SPLIT;
 #endif
 
-void eeconfig_read_rgb_matrix(void) { eeprom_read_block(&rgb_matrix_config, EECONFIG_RGB_MATRIX, sizeof(rgb_matrix_config)); }
+void eeconfig_read_rgb_matrix(void) { eeconfig_read_block(&rgb_matrix_config, EECONFIG_RGB_MATRIX, sizeof(rgb_matrix_config)); }
 
-void eeconfig_update_rgb_matrix(void) { eeprom_update_block(&rgb_matrix_config, EECONFIG_RGB_MATRIX, sizeof(rgb_matrix_config)); }
+void eeconfig_update_rgb_matrix(void) { eeconfig_update_block(&rgb_matrix_config, EECONFIG_RGB_MATRIX, sizeof(rgb_matrix_config)); }
 
 void eeconfig_update_rgb_matrix_default(void) {
     dprintf("eeconfig_update_rgb_matrix_default\n");
@@ -177,12 +262,7 @@ __attribute__((weak)) uint8_t rgb_matrix_map_row_column_to_led_kb(uint8_t row, u
 
 uint8_t rgb_matrix_map_row_column_to_led(uint8_t row, uint8_t column, uint8_t *led_i) {
     uint8_t led_count = rgb_matrix_map_row_column_to_led_kb(row, column, led_i);
-    uint8_t led_index = g_led_config.matrix_co[row][column];
-    if (led_index != NO_LED) {
-        led_i[led_count] = led_index;
-        led_count++;
-    }
-    return led_count;
+    return lighting_map_row_column_to_led(row, column, led_i, led_count);
 }
 
 void rgb_matrix_update_pwm_buffers(void) { rgb_matrix_driver.flush(); }
@@ -211,6 +291,9 @@ void process_rgb_matrix(uint8_t row, uint8_t col, bool pressed) {
 #if RGB_DISABLE_TIMEOUT > 0
     rgb_anykey_timer = 0;
 #endif  // RGB_DISABLE_TIMEOUT > 0
+#ifdef RGB_MATRIX_FRAME_BUDGET_US
+    rgb_typing_timer = timer_read32();
+#endif  // RGB_MATRIX_FRAME_BUDGET_US
 
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
     uint8_t led[LED_HITS_TO_REMEMBER];
@@ -225,22 +308,7 @@ void process_rgb_matrix(uint8_t row, uint8_t col, bool pressed) {
         led_count = rgb_matrix_map_row_column_to_led(row, col, led);
     }
 
-    if (last_hit_buffer.count + led_count > LED_HITS_TO_REMEMBER) {
-        memcpy(&last_hit_buffer.x[0], &last_hit_buffer.x[led_count], LED_HITS_TO_REMEMBER - led_count);
-        memcpy(&last_hit_buffer.y[0], &last_hit_buffer.y[led_count], LED_HITS_TO_REMEMBER - led_count);
-        memcpy(&last_hit_buffer.tick[0], &last_hit_buffer.tick[led_count], (LED_HITS_TO_REMEMBER - led_count) * 2);  // 16 bit
-        memcpy(&last_hit_buffer.index[0], &last_hit_buffer.index[led_count], LED_HITS_TO_REMEMBER - led_count);
-        last_hit_buffer.count--;
-    }
-
-    for (uint8_t i = 0; i < led_count; i++) {
-        uint8_t index                = last_hit_buffer.count;
-        last_hit_buffer.x[index]     = g_led_config.point[led[i]].x;
-        last_hit_buffer.y[index]     = g_led_config.point[led[i]].y;
-        last_hit_buffer.index[index] = led[i];
-        last_hit_buffer.tick[index]  = 0;
-        last_hit_buffer.count++;
-    }
+    lighting_hits_push(&last_hit_buffer, led, led_count);
 #endif  // RGB_MATRIX_KEYREACTIVE_ENABLED
 
 #if defined(RGB_MATRIX_FRAMEBUFFER_EFFECTS) && !defined(DISABLE_RGB_MATRIX_TYPING_HEATMAP)
@@ -283,6 +351,52 @@ static bool rgb_matrix_none(effect_params_t *params) {
     return false;
 }
 
+#ifdef RGB_MATRIX_FRAME_BUDGET_US
+// The frame budget governor sizes each render slice so that it takes about
+// RGB_MATRIX_FRAME_BUDGET_US, or RGB_MATRIX_TYPING_BUDGET_US while keys are
+// being pressed. Timers only tick once a millisecond, far coarser than a
+// slice, but a slice lasting d straddles a tick with probability d / 1ms.
+// Summing the ticks seen over many slices is therefore an unbiased measure
+// of the time spent, from which the per-LED cost is estimated.
+static bool rgb_governor_typing(void) { return timer_elapsed32(rgb_typing_timer) < RGB_MATRIX_TYPING_TIMEOUT; }
+
+static uint8_t rgb_governor_slice(void) {
+    uint32_t budget = rgb_governor_typing() ? RGB_MATRIX_TYPING_BUDGET_US : RGB_MATRIX_FRAME_BUDGET_US;
+    uint32_t leds   = (budget * 256) / rgb_led_cost;
+
+    if (leds < 1) return 1;
+    if (leds > DRIVER_LED_TOTAL) return DRIVER_LED_TOTAL;
+    return leds;
+}
+
+static void rgb_governor_rendered(uint8_t leds, uint32_t elapsed) {
+    rgb_render_us += elapsed * 1000;
+    rgb_render_leds += leds;
+
+    // Once enough ticks have been seen, or so many LEDs rendered without
+    // any that the window is a safe upper bound, fold in the new estimate.
+    if (rgb_render_us >= RGB_GOVERNOR_WINDOW * 1000UL || rgb_render_leds > UINT16_MAX - UINT8_MAX) {
+        uint32_t window = rgb_render_us > 1000 ? rgb_render_us : 1000;
+        uint32_t cost   = (window * 256) / rgb_render_leds;
+
+        rgb_led_cost = (rgb_led_cost * 3 + cost) / 4;
+        if (rgb_led_cost == 0) rgb_led_cost = 1;
+
+        rgb_render_us   = 0;
+        rgb_render_leds = 0;
+    }
+}
+
+static void rgb_governor_flushed(uint32_t elapsed) {
+    rgb_flush_us += elapsed * 1000;
+    if (++rgb_flush_count == RGB_GOVERNOR_FLUSHES) {
+        rgb_flush_cost  = rgb_flush_us / RGB_GOVERNOR_FLUSHES;
+        rgb_flush_us    = 0;
+        rgb_flush_count = 0;
+    }
+}
+#endif  // RGB_MATRIX_FRAME_BUDGET_US
+
 static void rgb_task_timers(void) {
 #if defined(RGB_MATRIX_KEYREACTIVE_ENABLED) || RGB_DISABLE_TIMEOUT > 0
     uint32_t deltaTime = sync_timer_elapsed32(rgb_timer_buffer);
@@ -291,31 +405,25 @@ static void rgb_task_timers(void) {
 
     // Update double buffer timers
 #if RGB_DISABLE_TIMEOUT > 0
-    if (rgb_anykey_timer < UINT32_MAX) {
-        if (UINT32_MAX - deltaTime < rgb_anykey_timer) {
-            rgb_anykey_timer = UINT32_MAX;
-        } else {
-            rgb_anykey_timer += deltaTime;
-        }
-    }
+    lighting_timer_add(&rgb_anykey_timer, deltaTime);
 #endif  // RGB_DISABLE_TIMEOUT > 0
 
     // Update double buffer last hit timers
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
-    uint8_t count = last_hit_buffer.count;
-    for (uint8_t i = 0; i < count; ++i) {
-        if (UINT16_MAX - deltaTime < last_hit_buffer.tick[i]) {
-            last_hit_buffer.count--;
-            continue;
-        }
-        last_hit_buffer.tick[i] += deltaTime;
-    }
+    lighting_hits_age(&last_hit_buffer, deltaTime);
 #endif  // RGB_MATRIX_KEYREACTIVE_ENABLED
 }
 
 static void rgb_task_sync(void) {
+    uint32_t interval = RGB_MATRIX_LED_FLUSH_LIMIT;
+#ifdef RGB_MATRIX_FRAME_BUDGET_US
+    // A flush can't be split up, so if it alone overruns the typing budget
+    // fall back to half the frame rate while keys are being pressed.
+    if (rgb_flush_cost > RGB_MATRIX_TYPING_BUDGET_US && rgb_governor_typing()) interval *= 2;
+#endif  // RGB_MATRIX_FRAME_BUDGET_US
+
     // next task
-    if (sync_timer_elapsed32(g_rgb_timer) >= RGB_MATRIX_LED_FLUSH_LIMIT) rgb_task_state = STARTING;
+    if (sync_timer_elapsed32(g_rgb_timer) >= interval) rgb_task_state = STARTING;
 }
 
 static void rgb_task_start(void) {
@@ -340,6 +448,12 @@ static void rgb_task_render(uint8_t effect) {
         rgb_matrix_set_color_all(0, 0, 0);
     }
 
+#ifdef RGB_MATRIX_FRAME_BUDGET_US
+    uint8_t slice = rgb_governor_slice();
+    g_rgb_led_min = rgb_effect_params.iter ? g_rgb_led_max : 0;
+    g_rgb_led_max = slice < DRIVER_LED_TOTAL - g_rgb_led_min ? g_rgb_led_min + slice : DRIVER_LED_TOTAL;
+#endif  // RGB_MATRIX_FRAME_BUDGET_US
+
     // each effect can opt to do calculations
     // and/or request PWM buffer updates.
     switch (effect) {
@@ -417,6 +531,10 @@ void rgb_matrix_task(void) {
 
     uint8_t effect = suspend_backlight || !rgb_matrix_config.enable ? 0 : rgb_matrix_config.mode;
 
+#ifdef RGB_MATRIX_FRAME_BUDGET_US
+    uint32_t start = timer_read32();
+#endif  // RGB_MATRIX_FRAME_BUDGET_US
+
     switch (rgb_task_state) {
         case STARTING:
             rgb_task_start();
@@ -427,9 +545,15 @@ void rgb_matrix_task(void) {
                 rgb_matrix_indicators();
                 rgb_matrix_indicators_advanced(&rgb_effect_params);
             }
+#ifdef RGB_MATRIX_FRAME_BUDGET_US
+            rgb_governor_rendered(g_rgb_led_max - g_rgb_led_min, timer_elapsed32(start));
+#endif  // RGB_MATRIX_FRAME_BUDGET_US
             break;
         case FLUSHING:
             rgb_task_flush(effect);
+#ifdef RGB_MATRIX_FRAME_BUDGET_US
+            rgb_governor_flushed(timer_elapsed32(start));
+#endif  // RGB_MATRIX_FRAME_BUDGET_US
             break;
         case SYNCING:
             rgb_task_sync();
@@ -452,7 +576,10 @@ void rgb_matrix_indicators_advanced(effect_params_t *params) {
      * and not sure which would be better. Otherwise, this should be called from
      * rgb_task_render, right before the iter++ line.
      */
-#if defined(RGB_MATRIX_LED_PROCESS_LIMIT) && RGB_MATRIX_LED_PROCESS_LIMIT > 0 && RGB_MATRIX_LED_PROCESS_LIMIT < DRIVER_LED_TOTAL
+#if defined(RGB_MATRIX_FRAME_BUDGET_US)
+    uint8_t min = g_rgb_led_min;
+    uint8_t max = g_rgb_led_max;
+#elif defined(RGB_MATRIX_LED_PROCESS_LIMIT) && RGB_MATRIX_LED_PROCESS_LIMIT > 0 && RGB_MATRIX_LED_PROCESS_LIMIT < DRIVER_LED_TOTAL
     uint8_t min = RGB_MATRIX_LED_PROCESS_LIMIT * (params->iter - 1);
     uint8_t max = min + RGB_MATRIX_LED_PROCESS_LIMIT;
     if (max > DRIVER_LED_TOTAL) max = DRIVER_LED_TOTAL;
@@ -468,19 +595,30 @@ __attribute__((weak)) void rgb_matrix_indicators_advanced_kb(uint8_t led_min, ui
 
 __attribute__((weak)) void rgb_matrix_indicators_advanced_user(uint8_t led_min, uint8_t led_max) {}
 
+#ifdef RGB_MATRIX_GEOMETRY_CACHE
+static void rgb_matrix_init_geometry(void) {
+    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
+        int16_t dx = g_led_config.point[i].x - k_rgb_matrix_center.x;
+        int16_t dy = g_led_config.point[i].y - k_rgb_matrix_center.y;
+
+        g_led_geometry[i].dx    = dx;
+        g_led_geometry[i].dy    = dy;
+        g_led_geometry[i].dist  = sqrt16(dx * dx + dy * dy);
+        g_led_geometry[i].angle = atan2_8(dy, dx);
+    }
+}
+#endif  // RGB_MATRIX_GEOMETRY_CACHE
+
 void rgb_matrix_init(void) {
     rgb_matrix_driver.init();
 
-#ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
-    g_last_hit_tracker.count = 0;
-    for (uint8_t i = 0; i < LED_HITS_TO_REMEMBER; ++i) {
-        g_last_hit_tracker.tick[i] = UINT16_MAX;
-    }
+#ifdef RGB_MATRIX_GEOMETRY_CACHE
+    rgb_matrix_init_geometry();
+#endif  // RGB_MATRIX_GEOMETRY_CACHE
 
-    last_hit_buffer.count = 0;
-    for (uint8_t i = 0; i < LED_HITS_TO_REMEMBER; ++i) {
-        last_hit_buffer.tick[i] = UINT16_MAX;
-    }
+#ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
+    lighting_hits_clear(&g_last_hit_tracker);
+    lighting_hits_clear(&last_hit_buffer);
 #endif  // RGB_MATRIX_KEYREACTIVE_ENABLED
 
     if (!eeconfig_is_enabled()) {
@@ -45,7 +45,12 @@
 #    define RGB_MATRIX_LED_PROCESS_LIMIT (DRIVER_LED_TOTAL + 4) / 5
 #endif
 
-#if defined(RGB_MATRIX_LED_PROCESS_LIMIT) && RGB_MATRIX_LED_PROCESS_LIMIT > 0 && RGB_MATRIX_LED_PROCESS_LIMIT < DRIVER_LED_TOTAL
+#if defined(RGB_MATRIX_FRAME_BUDGET_US)
+// Slice bounds are chosen by the frame budget governor in rgb_matrix.c
+#    define RGB_MATRIX_USE_LIMITS(min, max) \
+        uint8_t min = g_rgb_led_min;        \
+        uint8_t max = g_rgb_led_max;
+#elif defined(RGB_MATRIX_LED_PROCESS_LIMIT) && RGB_MATRIX_LED_PROCESS_LIMIT > 0 && RGB_MATRIX_LED_PROCESS_LIMIT < DRIVER_LED_TOTAL
 #    define RGB_MATRIX_USE_LIMITS(min, max)                        \
         uint8_t min = RGB_MATRIX_LED_PROCESS_LIMIT * params->iter; \
         uint8_t max = min + RGB_MATRIX_LED_PROCESS_LIMIT;          \
@@ -221,6 +226,13 @@ extern led_config_t g_led_config;
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
 extern last_hit_t g_last_hit_tracker;
 #endif
+#ifdef RGB_MATRIX_FRAME_BUDGET_US
+extern uint8_t g_rgb_led_min;
+extern uint8_t g_rgb_led_max;
+#endif
+#ifdef RGB_MATRIX_GEOMETRY_CACHE
+extern led_geometry_t g_led_geometry[DRIVER_LED_TOTAL];
+#endif
 #ifdef RGB_MATRIX_FRAMEBUFFER_EFFECTS
 extern uint8_t g_rgb_frame_buffer[MATRIX_ROWS][MATRIX_COLS];
 #endif
@@ -0,0 +1,38 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Synthetic layouts for the effect benchmark, selected with RGB_BENCH_LEDS
+#ifndef RGB_BENCH_LEDS
+#    define RGB_BENCH_LEDS 87
+#endif
+
+#if RGB_BENCH_LEDS <= 30
+#    define MATRIX_ROWS 3
+#    define MATRIX_COLS 10
+#elif RGB_BENCH_LEDS <= 90
+#    define MATRIX_ROWS 6
+#    define MATRIX_COLS 15
+#else
+#    define MATRIX_ROWS 10
+#    define MATRIX_COLS 20
+#endif
+
+#define DRIVER_LED_TOTAL RGB_BENCH_LEDS
+
+#define RGB_MATRIX_KEYPRESSES
+#define RGB_MATRIX_FRAMEBUFFER_EFFECTS
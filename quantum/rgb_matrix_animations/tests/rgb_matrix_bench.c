@@ -0,0 +1,161 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rgb_matrix_bench.h"
+#include "rgb_matrix.h"
+#include "eeconfig.h"
+#include "timer.h"
+#include <string.h>
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+
+// Frames between simulated key presses
+#define RGB_BENCH_KEY_INTERVAL 5
+
+led_config_t g_led_config;
+
+static rgb_bench_stats_t stats;
+static uint8_t           eeprom[EECONFIG_SIZE];
+static uint32_t          rand_state;
+static bool              flushed;
+
+static const char *const effect_names[] = {
+    "NONE",
+#define RGB_MATRIX_EFFECT(name, ...) #name,
+#include "rgb_matrix_animations/rgb_matrix_effects.inc"
+#undef RGB_MATRIX_EFFECT
+};
+
+// Deterministic replacement for the C library's rand(), so the raindrop and
+// digital rain checksums are the same on every host
+int rand(void) {
+    rand_state = rand_state * 1103515245 + 12345;
+    return (rand_state >> 1) & RAND_MAX;
+}
+
+void srand(unsigned int seed) { rand_state = seed; }
+
+// Keyboard hooks rgb_matrix relies on
+bool is_keyboard_left(void) { return true; }
+bool is_keyboard_master(void) { return true; }
+bool eeconfig_is_enabled(void) { return true; }
+void eeconfig_init(void) {}
+
+// Backing store for the rgb_matrix config block, which doesn't fit in the
+// shared test EEPROM
+void eeprom_read_block(void *buf, const void *addr, size_t len) { memcpy(buf, &eeprom[(uintptr_t)addr], len); }
+
+void eeprom_update_block(const void *buf, void *addr, size_t len) { memcpy(&eeprom[(uintptr_t)addr], buf, len); }
+
+void eeconfig_read_block(void *buf, const void *addr, size_t len) { eeprom_read_block(buf, addr, len); }
+
+void eeconfig_update_block(const void *buf, void *addr, size_t len) { eeprom_update_block(buf, addr, len); }
+
+void rgb_matrix_indicators_advanced_user(uint8_t led_min, uint8_t led_max) { stats.slices++; }
+
+static void bench_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
+    uint8_t bytes[4] = {index, red, green, blue};
+
+    for (uint8_t i = 0; i < sizeof(bytes); i++) {
+        stats.checksum = (stats.checksum ^ bytes[i]) * 16777619UL;
+    }
+    stats.set_color_calls++;
+}
+
+static void bench_set_color_all(uint8_t red, uint8_t green, uint8_t blue) {
+    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
+        bench_set_color(i, red, green, blue);
+    }
+}
+
+static void bench_init(void) {}
+static void bench_flush(void) {
+    flushed = true;
+    stats.flushes++;
+}
+
+const rgb_matrix_driver_t rgb_matrix_driver = {
+    .init          = bench_init,
+    .set_color     = bench_set_color,
+    .set_color_all = bench_set_color_all,
+    .flush         = bench_flush,
+};
+
+void rgb_bench_init(void) {
+    memset(&g_led_config, 0, sizeof(g_led_config));
+    memset(g_led_config.matrix_co, NO_LED, sizeof(g_led_config.matrix_co));
+
+    // Fill the matrix row by row and spread the LEDs over the full
+    // 224x64 coordinate space, with modifiers at either end of each row
+    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
+        uint8_t row = i / MATRIX_COLS;
+        uint8_t col = i % MATRIX_COLS;
+
+        g_led_config.matrix_co[row][col] = i;
+        g_led_config.point[i].x          = col * 224 / (MATRIX_COLS - 1);
+        g_led_config.point[i].y          = row * 64 / (MATRIX_ROWS - 1);
+        g_led_config.flags[i]            = LED_FLAG_KEYLIGHT;
+        if (col == 0 || col == MATRIX_COLS - 1) {
+            g_led_config.flags[i] |= LED_FLAG_MODIFIER;
+        }
+    }
+
+    set_time(0);
+    rgb_matrix_init();
+    rgb_matrix_enable_noeeprom();
+}
+
+uint8_t rgb_bench_effect_count(void) { return RGB_MATRIX_EFFECT_MAX; }
+
+const char *rgb_bench_effect_name(uint8_t mode) { return mode < sizeof(effect_names) / sizeof(effect_names[0]) ? effect_names[mode] : "?"; }
+
+static void bench_finish_frame(void) {
+    flushed = false;
+    for (uint16_t i = 0; i < 1024 && !flushed; i++) {
+        rgb_matrix_task();
+    }
+}
+
+void rgb_bench_start(uint8_t mode) {
+    // Let the previous effect finish its frame so the new one starts from
+    // the first slice, then reset time and the key hit trackers
+    bench_finish_frame();
+    set_time(0);
+    rgb_matrix_init();
+
+    rgb_matrix_mode_noeeprom(mode);
+    rgb_matrix_sethsv_noeeprom(0, UINT8_MAX, UINT8_MAX);
+    rgb_matrix_set_speed_noeeprom(UINT8_MAX / 2);
+
+    srand(1);
+    memset(&stats, 0, sizeof(stats));
+    stats.checksum = 2166136261UL;
+}
+
+void rgb_bench_frame(void) {
+    advance_time(RGB_MATRIX_LED_FLUSH_LIMIT);
+
+    if (stats.frames % RGB_BENCH_KEY_INTERVAL == 0) {
+        uint8_t key = (stats.frames / RGB_BENCH_KEY_INTERVAL * 7) % DRIVER_LED_TOTAL;
+        process_rgb_matrix(key / MATRIX_COLS, key % MATRIX_COLS, true);
+    }
+
+    bench_finish_frame();
+    stats.frames++;
+}
+
+const rgb_bench_stats_t *rgb_bench_stats(void) { return &stats; }
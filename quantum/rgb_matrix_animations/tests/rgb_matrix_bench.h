@@ -0,0 +1,51 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint32_t frames;
+    uint32_t flushes;
+    uint32_t slices;           // render passes, summed over all frames
+    uint32_t set_color_calls;  // driver set_color calls, set_color_all counts as one per LED
+    uint32_t checksum;         // FNV-1a over every colour written, in order
+} rgb_bench_stats_t;
+
+// Builds the synthetic layout and brings up rgb_matrix with the mock driver
+void rgb_bench_init(void);
+
+uint8_t     rgb_bench_effect_count(void);
+const char *rgb_bench_effect_name(uint8_t mode);
+
+// Switches to an effect and resets time, the random seed and the statistics,
+// so every run of an effect renders the exact same frames
+void rgb_bench_start(uint8_t mode);
+// Advances time by one frame interval, presses a key every few frames and
+// runs the task until the frame has been flushed
+void rgb_bench_frame(void);
+
+const rgb_bench_stats_t *rgb_bench_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
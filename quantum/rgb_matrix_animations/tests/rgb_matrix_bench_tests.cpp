@@ -0,0 +1,258 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+extern "C" {
+#include "rgb_matrix_bench.h"
+#include "lighting_core.h"
+}
+
+namespace {
+const uint32_t bench_frames = 256;
+
+struct golden_t {
+    const char* effect;
+    uint32_t    checksum;
+};
+
+// Checksums of the first bench_frames frames of every effect. If an effect
+// is changed on purpose, run the benchmark and update its entry here.
+const golden_t golden[] = {
+#if RGB_BENCH_LEDS == 30
+    {"SOLID_COLOR", 0x2f6aa1c5},
+    {"ALPHAS_MODS", 0xf6e2b5c5},
+    {"GRADIENT_UP_DOWN", 0x777d95c5},
+    {"GRADIENT_LEFT_RIGHT", 0x010643c5},
+    {"BREATHING", 0x13310151},
+    {"BAND_SAT", 0x1096f322},
+    {"BAND_VAL", 0x023d41e7},
+    {"BAND_PINWHEEL_SAT", 0x3590d11d},
+    {"BAND_PINWHEEL_VAL", 0x9c0168c9},
+    {"BAND_SPIRAL_SAT", 0x4c4aac2a},
+    {"BAND_SPIRAL_VAL", 0x4577b3c5},
+    {"CYCLE_ALL", 0x477cab01},
+    {"CYCLE_LEFT_RIGHT", 0x9fe71725},
+    {"CYCLE_UP_DOWN", 0xc49b428d},
+    {"RAINBOW_MOVING_CHEVRON", 0x40afbd49},
+    {"CYCLE_OUT_IN", 0x9ad1115f},
+    {"CYCLE_OUT_IN_DUAL", 0x13381a15},
+    {"CYCLE_PINWHEEL", 0x80f5962d},
+    {"CYCLE_SPIRAL", 0x79f0324b},
+    {"DUAL_BEACON", 0xef9cb1ad},
+    {"RAINBOW_BEACON", 0xe28113c1},
+    {"RAINBOW_PINWHEELS", 0xf9d7cdf1},
+    {"RAINDROPS", 0xbf18c27d},
+    {"JELLYBEAN_RAINDROPS", 0xab8a9dab},
+    {"HUE_BREATHING", 0x044a6075},
+    {"HUE_PENDULUM", 0xfbb453cf},
+    {"HUE_WAVE", 0x83d85349},
+    {"TYPING_HEATMAP", 0xcb8c7dbf},
+    {"DIGITAL_RAIN", 0x16c0d8ab},
+    {"SOLID_REACTIVE_SIMPLE", 0x7fe6ec65},
+    {"SOLID_REACTIVE", 0xb42f2ef1},
+    {"SOLID_REACTIVE_WIDE", 0xfb19d9e4},
+    {"SOLID_REACTIVE_MULTIWIDE", 0x9cbc3c0e},
+    {"SOLID_REACTIVE_CROSS", 0x5fdcd523},
+    {"SOLID_REACTIVE_MULTICROSS", 0x58fbcdae},
+    {"SOLID_REACTIVE_NEXUS", 0x3918c0c6},
+    {"SOLID_REACTIVE_MULTINEXUS", 0x767cdf18},
+    {"SPLASH", 0x1ce4c515},
+    {"MULTISPLASH", 0x2d775e50},
+    {"SOLID_SPLASH", 0x081fe5dd},
+    {"SOLID_MULTISPLASH", 0xefe4d649},
+#elif RGB_BENCH_LEDS == 87
+    {"SOLID_COLOR", 0xd0b643c5},
+    {"ALPHAS_MODS", 0xc27e5dc5},
+    {"GRADIENT_UP_DOWN", 0x09c3e3c5},
+    {"GRADIENT_LEFT_RIGHT", 0x0f6e5dc5},
+    {"BREATHING", 0x9803dbf7},
+    {"BAND_SAT", 0x409b8122},
+    {"BAND_VAL", 0x1c8cb413},
+    {"BAND_PINWHEEL_SAT", 0xd085abc1},
+    {"BAND_PINWHEEL_VAL", 0xa00383bd},
+    {"BAND_SPIRAL_SAT", 0x9b5b1cf1},
+    {"BAND_SPIRAL_VAL", 0xe4c9e340},
+    {"CYCLE_ALL", 0x0cfac04f},
+    {"CYCLE_LEFT_RIGHT", 0x5acdd6e9},
+    {"CYCLE_UP_DOWN", 0xe038c77b},
+    {"RAINBOW_MOVING_CHEVRON", 0xe70d3cf5},
+    {"CYCLE_OUT_IN", 0x43cad6ad},
+    {"CYCLE_OUT_IN_DUAL", 0x05ab6381},
+    {"CYCLE_PINWHEEL", 0x8dfcb7fb},
+    {"CYCLE_SPIRAL", 0xe16685dd},
+    {"DUAL_BEACON", 0x50b024b9},
+    {"RAINBOW_BEACON", 0x1bc4b4e1},
+    {"RAINBOW_PINWHEELS", 0x7e836761},
+    {"RAINDROPS", 0xa47afd08},
+    {"JELLYBEAN_RAINDROPS", 0xb80f1f8b},
+    {"HUE_BREATHING", 0xfb17f781},
+    {"HUE_PENDULUM", 0xf6c00503},
+    {"HUE_WAVE", 0xee70a681},
+    {"TYPING_HEATMAP", 0x3b1ad84d},
+    {"DIGITAL_RAIN", 0x4f6f208e},
+    {"SOLID_REACTIVE_SIMPLE", 0xbc30b401},
+    {"SOLID_REACTIVE", 0x77fc29f1},
+    {"SOLID_REACTIVE_WIDE", 0x71ee5b1f},
+    {"SOLID_REACTIVE_MULTIWIDE", 0xe825355d},
+    {"SOLID_REACTIVE_CROSS", 0x0924f049},
+    {"SOLID_REACTIVE_MULTICROSS", 0xe0588887},
+    {"SOLID_REACTIVE_NEXUS", 0xcb7f3dfc},
+    {"SOLID_REACTIVE_MULTINEXUS", 0xbc592a35},
+    {"SPLASH", 0x84261cef},
+    {"MULTISPLASH", 0x9da57787},
+    {"SOLID_SPLASH", 0x76fc75a9},
+    {"SOLID_MULTISPLASH", 0x6d7e1002},
+#elif RGB_BENCH_LEDS == 200
+    {"SOLID_COLOR", 0xec0a2dc5},
+    {"ALPHAS_MODS", 0xe5c765c5},
+    {"GRADIENT_UP_DOWN", 0xa7e0e9c5},
+    {"GRADIENT_LEFT_RIGHT", 0x030e75c5},
+    {"BREATHING", 0xefe4354d},
+    {"BAND_SAT", 0x2cb214d9},
+    {"BAND_VAL", 0xcd49885d},
+    {"BAND_PINWHEEL_SAT", 0xb5ea40d5},
+    {"BAND_PINWHEEL_VAL", 0x0cc3f3bd},
+    {"BAND_SPIRAL_SAT", 0x63dee6f1},
+    {"BAND_SPIRAL_VAL", 0x2ef17224},
+    {"CYCLE_ALL", 0x66eb0dfd},
+    {"CYCLE_LEFT_RIGHT", 0x03acd67d},
+    {"CYCLE_UP_DOWN", 0x79d5942d},
+    {"RAINBOW_MOVING_CHEVRON", 0x7917c161},
+    {"CYCLE_OUT_IN", 0x9d3f8ed3},
+    {"CYCLE_OUT_IN_DUAL", 0xf5e939cf},
+    {"CYCLE_PINWHEEL", 0x976ef525},
+    {"CYCLE_SPIRAL", 0x01ceb63d},
+    {"DUAL_BEACON", 0x43a9fde7},
+    {"RAINBOW_BEACON", 0xfb4d46f9},
+    {"RAINBOW_PINWHEELS", 0x499e9db1},
+    {"RAINDROPS", 0xdfdc6106},
+    {"JELLYBEAN_RAINDROPS", 0x24c91640},
+    {"HUE_BREATHING", 0x73f4ccc5},
+    {"HUE_PENDULUM", 0x0e4274e5},
+    {"HUE_WAVE", 0x77e593ed},
+    {"TYPING_HEATMAP", 0xfd6195c2},
+    {"DIGITAL_RAIN", 0x1c397f90},
+    {"SOLID_REACTIVE_SIMPLE", 0xaf5244cd},
+    {"SOLID_REACTIVE", 0x980ee201},
+    {"SOLID_REACTIVE_WIDE", 0x98671b2a},
+    {"SOLID_REACTIVE_MULTIWIDE", 0x92faff19},
+    {"SOLID_REACTIVE_CROSS", 0xc18772a7},
+    {"SOLID_REACTIVE_MULTICROSS", 0xbf426682},
+    {"SOLID_REACTIVE_NEXUS", 0x910e95d0},
+    {"SOLID_REACTIVE_MULTINEXUS", 0x0e74d477},
+    {"SPLASH", 0xd8984ce0},
+    {"MULTISPLASH", 0xff42ce1e},
+    {"SOLID_SPLASH", 0xe44965c4},
+    {"SOLID_MULTISPLASH", 0x9530efa3},
+#endif
+};
+
+const golden_t* find_golden(const char* effect) {
+    for (const golden_t& entry : golden) {
+        if (strcmp(entry.effect, effect) == 0) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+// A ring as wide as it gets, whose squared radii don't fit in 16 bits
+bool far_ring_reach(uint16_t tick, uint8_t* inner, uint8_t* outer) {
+    *inner = 200;
+    *outer = 255;
+    return true;
+}
+
+// Masks of the hits that can light at least one point of every bucket
+void reachable_buckets(const last_hit_t* hits, uint8_t inner, uint8_t outer, lighting_splash_mask_t* masks) {
+    memset(masks, 0, sizeof(g_lighting_splash_grid));
+    for (uint8_t j = 0; j < hits->count; j++) {
+        for (int x = 0; x <= UINT8_MAX; x++) {
+            for (int y = 0; y <= UINT8_MAX; y++) {
+                uint32_t dsq = (x - hits->x[j]) * (x - hits->x[j]) + (y - hits->y[j]) * (y - hits->y[j]);
+                if (dsq > UINT16_MAX || (dsq >= (uint32_t)inner * inner && dsq < (uint32_t)(outer + 1) * (outer + 1))) {
+                    masks[LIGHTING_SPLASH_BUCKET(x, y)] |= (lighting_splash_mask_t)1 << j;
+                }
+            }
+        }
+    }
+}
+}  // namespace
+
+TEST(LightingSplashIndex, KeepsHitsWithFullReach) {
+    last_hit_t hits = {};
+    hits.count      = 2;
+    hits.x[1]       = 224;
+    hits.y[1]       = 64;
+
+    lighting_splash_mask_t expected[LIGHTING_SPLASH_GRID_COLS * LIGHTING_SPLASH_GRID_ROWS];
+
+    // Without a reach function every hit can light every bucket
+    lighting_splash_index(&hits, 0, 0, nullptr);
+    for (auto mask : g_lighting_splash_grid) {
+        EXPECT_EQ(mask, 0x03);
+    }
+
+    lighting_splash_index(&hits, 0, 0, far_ring_reach);
+    reachable_buckets(&hits, 200, 255, expected);
+    for (int i = 0; i < LIGHTING_SPLASH_GRID_COLS * LIGHTING_SPLASH_GRID_ROWS; i++) {
+        EXPECT_EQ(g_lighting_splash_grid[i], expected[i]) << "bucket " << i;
+    }
+    // The ring starts past the first bucket, and reaches across the board
+    EXPECT_EQ(g_lighting_splash_grid[0] & 0x01, 0);
+    EXPECT_EQ(g_lighting_splash_grid[LIGHTING_SPLASH_GRID_COLS - 1] & 0x01, 0x01);
+}
+
+class RgbMatrixBench : public testing::Test {
+   protected:
+    void SetUp() override { rgb_bench_init(); }
+
+    double run(uint8_t mode) {
+        rgb_bench_start(mode);
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < bench_frames; i++) {
+            rgb_bench_frame();
+        }
+        std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / bench_frames;
+    }
+};
+
+TEST_F(RgbMatrixBench, EffectsMatchGoldenFrames) {
+    printf("%-24s %10s %8s %10s %10s\n", "effect", "us/frame", "slices", "set_color", "checksum");
+
+    for (uint8_t mode = 1; mode < rgb_bench_effect_count(); mode++) {
+        double                   us    = run(mode);
+        const rgb_bench_stats_t* stats = rgb_bench_stats();
+        const char*              name  = rgb_bench_effect_name(mode);
+
+        printf("%-24s %10.2f %8.2f %10.1f   0x%08x\n", name, us, (double)stats->slices / stats->frames, (double)stats->set_color_calls / stats->frames, stats->checksum);
+
+        EXPECT_EQ(stats->flushes, bench_frames) << name << " did not finish every frame";
+
+        const golden_t* expected = find_golden(name);
+        if (expected == nullptr) {
+            ADD_FAILURE() << "No golden checksum for " << name;
+        } else {
+            EXPECT_EQ(stats->checksum, expected->checksum) << name << " renders different frames";
+        }
+    }
+}
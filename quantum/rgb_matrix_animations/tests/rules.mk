@@ -0,0 +1,23 @@
+rgb_matrix_bench_30_CONFIG := $(QUANTUM_PATH)/rgb_matrix_animations/tests/config.h
+rgb_matrix_bench_30_DEFS := -DNO_DEBUG -DNO_PRINT -DRGB_BENCH_LEDS=30
+rgb_matrix_bench_30_INC := $(QUANTUM_PATH)/rgb_matrix_animations/tests
+
+rgb_matrix_bench_30_SRC := \
+	$(QUANTUM_PATH)/rgb_matrix_animations/tests/rgb_matrix_bench_tests.cpp \
+	$(QUANTUM_PATH)/rgb_matrix_animations/tests/rgb_matrix_bench.c \
+	$(QUANTUM_PATH)/rgb_matrix.c \
+	$(QUANTUM_PATH)/lighting_core.c \
+	$(QUANTUM_PATH)/color.c \
+	$(QUANTUM_PATH)/led_tables.c \
+	$(LIB_PATH)/lib8tion/lib8tion.c \
+	$(TMK_PATH)/common/test/timer.c
+
+rgb_matrix_bench_87_CONFIG := $(rgb_matrix_bench_30_CONFIG)
+rgb_matrix_bench_87_DEFS := -DNO_DEBUG -DNO_PRINT -DRGB_BENCH_LEDS=87
+rgb_matrix_bench_87_INC := $(rgb_matrix_bench_30_INC)
+rgb_matrix_bench_87_SRC := $(rgb_matrix_bench_30_SRC)
+
+rgb_matrix_bench_200_CONFIG := $(rgb_matrix_bench_30_CONFIG)
+rgb_matrix_bench_200_DEFS := -DNO_DEBUG -DNO_PRINT -DRGB_BENCH_LEDS=200
+rgb_matrix_bench_200_INC := $(rgb_matrix_bench_30_INC)
+rgb_matrix_bench_200_SRC := $(rgb_matrix_bench_30_SRC)
@@ -0,0 +1,4 @@
+TEST_LIST +=\
+	rgb_matrix_bench_30\
+	rgb_matrix_bench_87\
+	rgb_matrix_bench_200
@@ -6,26 +6,43 @@ RGB_MATRIX_EFFECT(TYPING_HEATMAP)
 #            define RGB_MATRIX_TYPING_HEATMAP_DECREASE_DELAY_MS 25
 #        endif
 
+// Heat is decayed lazily: g_rgb_frame_buffer holds each cell's heat as of
+// the decay tick it was last touched, and the current heat is worked out
+// from the number of ticks since then.
+static uint8_t heatmap_ticks;
+static uint8_t heatmap_touched[MATRIX_ROWS][MATRIX_COLS];
+// The matrix cell driving each LED, or NO_LED, built when the effect starts.
+static uint8_t heatmap_led_cell[DRIVER_LED_TOTAL];
+
+_Static_assert(MATRIX_ROWS * MATRIX_COLS < NO_LED, "TYPING_HEATMAP needs fewer than 255 matrix positions");
+
+static uint8_t heatmap_read(uint8_t row, uint8_t col) { return qsub8(g_rgb_frame_buffer[row][col], heatmap_ticks - heatmap_touched[row][col]); }
+
+static void heatmap_add(uint8_t row, uint8_t col, uint8_t heat) {
+    g_rgb_frame_buffer[row][col] = qadd8(heatmap_read(row, col), heat);
+    heatmap_touched[row][col]    = heatmap_ticks;
+}
+
 void process_rgb_matrix_typing_heatmap(uint8_t row, uint8_t col) {
     uint8_t m_row = row - 1;
     uint8_t p_row = row + 1;
     uint8_t m_col = col - 1;
     uint8_t p_col = col + 1;
 
-    if (m_col < col) g_rgb_frame_buffer[row][m_col] = qadd8(g_rgb_frame_buffer[row][m_col], 16);
-    g_rgb_frame_buffer[row][col] = qadd8(g_rgb_frame_buffer[row][col], 32);
-    if (p_col < MATRIX_COLS) g_rgb_frame_buffer[row][p_col] = qadd8(g_rgb_frame_buffer[row][p_col], 16);
+    if (m_col < col) heatmap_add(row, m_col, 16);
+    heatmap_add(row, col, 32);
+    if (p_col < MATRIX_COLS) heatmap_add(row, p_col, 16);
 
     if (p_row < MATRIX_ROWS) {
-        if (m_col < col) g_rgb_frame_buffer[p_row][m_col] = qadd8(g_rgb_frame_buffer[p_row][m_col], 13);
-        g_rgb_frame_buffer[p_row][col] = qadd8(g_rgb_frame_buffer[p_row][col], 16);
-        if (p_col < MATRIX_COLS) g_rgb_frame_buffer[p_row][p_col] = qadd8(g_rgb_frame_buffer[p_row][p_col], 13);
+        if (m_col < col) heatmap_add(p_row, m_col, 13);
+        heatmap_add(p_row, col, 16);
+        if (p_col < MATRIX_COLS) heatmap_add(p_row, p_col, 13);
     }
 
     if (m_row < row) {
-        if (m_col < col) g_rgb_frame_buffer[m_row][m_col] = qadd8(g_rgb_frame_buffer[m_row][m_col], 13);
-        g_rgb_frame_buffer[m_row][col] = qadd8(g_rgb_frame_buffer[m_row][col], 16);
-        if (p_col < MATRIX_COLS) g_rgb_frame_buffer[m_row][p_col] = qadd8(g_rgb_frame_buffer[m_row][p_col], 13);
+        if (m_col < col) heatmap_add(m_row, m_col, 13);
+        heatmap_add(m_row, col, 16);
+        if (p_col < MATRIX_COLS) heatmap_add(m_row, p_col, 13);
     }
 }
 
@@ -34,15 +51,30 @@ static uint16_t heatmap_decrease_timer;
 // Whether we should decrement the heatmap values during the next update.
 static bool decrease_heatmap_values;
 
+static void heatmap_init(void) {
+    memset(g_rgb_frame_buffer, 0, sizeof g_rgb_frame_buffer);
+    memset(heatmap_touched, 0, sizeof heatmap_touched);
+    memset(heatmap_led_cell, NO_LED, sizeof heatmap_led_cell);
+    heatmap_ticks          = 0;
+    heatmap_decrease_timer = timer_read();
+
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            uint8_t led[LED_HITS_TO_REMEMBER];
+            uint8_t led_count = rgb_matrix_map_row_column_to_led(row, col, led);
+            for (uint8_t j = 0; j < led_count; ++j) {
+                heatmap_led_cell[led[j]] = row * MATRIX_COLS + col;
+            }
+        }
+    }
+}
+
 bool TYPING_HEATMAP(effect_params_t* params) {
-    // Modified version of RGB_MATRIX_USE_LIMITS to work off of matrix row / col size
-    uint8_t led_min = RGB_MATRIX_LED_PROCESS_LIMIT * params->iter;
-    uint8_t led_max = led_min + RGB_MATRIX_LED_PROCESS_LIMIT;
-    if (led_max > sizeof(g_rgb_frame_buffer)) led_max = sizeof(g_rgb_frame_buffer);
+    RGB_MATRIX_USE_LIMITS(led_min, led_max);
 
     if (params->init) {
         rgb_matrix_set_color_all(0, 0, 0);
-        memset(g_rgb_frame_buffer, 0, sizeof g_rgb_frame_buffer);
+        heatmap_init();
     }
 
     // The heatmap animation might run in several iterations depending on
@@ -57,29 +89,36 @@ bool TYPING_HEATMAP(effect_params_t* params) {
         }
     }
 
-    // Render heatmap & decrease
-    for (int i = led_min; i < led_max; i++) {
-        uint8_t row = i % MATRIX_ROWS;
-        uint8_t col = i / MATRIX_ROWS;
-        uint8_t val = g_rgb_frame_buffer[row][col];
+    // Cold keys all share the same colour
+    RGB cold = rgb_matrix_hsv_to_rgb((HSV){170, rgb_matrix_config.hsv.s, 0});
 
-        // set the pixel colour
-        uint8_t led[LED_HITS_TO_REMEMBER];
-        uint8_t led_count = rgb_matrix_map_row_column_to_led(row, col, led);
-        for (uint8_t j = 0; j < led_count; ++j) {
-            if (!HAS_ANY_FLAGS(g_led_config.flags[led[j]], params->flags)) continue;
+    for (uint8_t i = led_min; i < led_max; i++) {
+        uint8_t cell = heatmap_led_cell[i];
+        if (cell == NO_LED) continue;
 
-            HSV hsv = {170 - qsub8(val, 85), rgb_matrix_config.hsv.s, scale8((qadd8(170, val) - 170) * 3, rgb_matrix_config.hsv.v)};
-            RGB rgb = rgb_matrix_hsv_to_rgb(hsv);
-            rgb_matrix_set_color(led[j], rgb.r, rgb.g, rgb.b);
+        uint8_t row = cell / MATRIX_COLS;
+        uint8_t col = cell % MATRIX_COLS;
+        uint8_t val = 0;
+        if (g_rgb_frame_buffer[row][col]) {
+            val = heatmap_read(row, col);
+            // Fully cooled down, so forget when it was last touched
+            if (!val) g_rgb_frame_buffer[row][col] = 0;
         }
 
-        if (decrease_heatmap_values) {
-            g_rgb_frame_buffer[row][col] = qsub8(val, 1);
+        if (!HAS_ANY_FLAGS(g_led_config.flags[i], params->flags)) continue;
+
+        RGB rgb = cold;
+        if (val) {
+            HSV hsv = {170 - qsub8(val, 85), rgb_matrix_config.hsv.s, scale8((qadd8(170, val) - 170) * 3, rgb_matrix_config.hsv.v)};
+            rgb     = rgb_matrix_hsv_to_rgb(hsv);
         }
+        rgb_matrix_set_color(i, rgb.r, rgb.g, rgb.b);
     }
 
-    return led_max < sizeof(g_rgb_frame_buffer);
+    // The decrease applies to the next frame, once every LED has been drawn
+    bool rendering = led_max < DRIVER_LED_TOTAL;
+    if (!rendering && decrease_heatmap_values) heatmap_ticks++;
+    return rendering;
 }
 
 #    endif  // RGB_MATRIX_CUSTOM_EFFECT_IMPLS
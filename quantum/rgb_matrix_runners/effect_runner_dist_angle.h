@@ -0,0 +1,17 @@
+#pragma once
+
+typedef HSV (*dist_angle_f)(HSV hsv, uint8_t dist, uint8_t angle, uint8_t time);
+
+bool effect_runner_dist_angle(effect_params_t* params, dist_angle_f effect_func) {
+    RGB_MATRIX_USE_LIMITS(led_min, led_max);
+
+    rgb_matrix_span_t span = {0};
+
+    uint8_t time = scale16by8(g_rgb_timer, rgb_matrix_config.speed / 2);
+    for (uint8_t i = led_min; i < led_max; i++) {
+        RGB_MATRIX_TEST_LED_FLAGS();
+        rgb_matrix_span_push(&span, i, effect_func(rgb_matrix_config.hsv, RGB_MATRIX_LED_DIST(i), RGB_MATRIX_LED_ANGLE(i), time));
+    }
+    rgb_matrix_span_flush(&span);
+    return led_max < DRIVER_LED_TOTAL;
+}
@@ -4,26 +4,35 @@
 
 typedef HSV (*reactive_splash_f)(HSV hsv, int16_t dx, int16_t dy, uint8_t dist, uint16_t tick);
 
-bool effect_runner_reactive_splash(uint8_t start, effect_params_t* params, reactive_splash_f effect_func) {
+bool effect_runner_reactive_splash_reach(uint8_t start, effect_params_t* params, reactive_splash_f effect_func, lighting_splash_reach_f reach_func) {
     RGB_MATRIX_USE_LIMITS(led_min, led_max);
 
-    uint8_t count = g_last_hit_tracker.count;
+    if (params->iter == 0) lighting_splash_index(&g_last_hit_tracker, rgb_matrix_config.speed, start, reach_func);
+
+    rgb_matrix_span_t span = {0};
+
     for (uint8_t i = led_min; i < led_max; i++) {
         RGB_MATRIX_TEST_LED_FLAGS();
         HSV hsv = rgb_matrix_config.hsv;
         hsv.v   = 0;
-        for (uint8_t j = start; j < count; j++) {
+
+        lighting_splash_mask_t hits = g_lighting_splash_grid[LIGHTING_SPLASH_BUCKET(g_led_config.point[i].x, g_led_config.point[i].y)];
+        for (uint8_t j = 0; hits; j++, hits >>= 1) {
+            if (!(hits & 1)) continue;
             int16_t  dx   = g_led_config.point[i].x - g_last_hit_tracker.x[j];
             int16_t  dy   = g_led_config.point[i].y - g_last_hit_tracker.y[j];
             uint8_t  dist = sqrt16(dx * dx + dy * dy);
             uint16_t tick = scale16by8(g_last_hit_tracker.tick[j], rgb_matrix_config.speed);
             hsv           = effect_func(hsv, dx, dy, dist, tick);
         }
-        hsv.v   = scale8(hsv.v, rgb_matrix_config.hsv.v);
-        RGB rgb = rgb_matrix_hsv_to_rgb(hsv);
-        rgb_matrix_set_color(i, rgb.r, rgb.g, rgb.b);
+        hsv.v = scale8(hsv.v, rgb_matrix_config.hsv.v);
+        rgb_matrix_span_push(&span, i, hsv);
     }
+    rgb_matrix_span_flush(&span);
     return led_max < DRIVER_LED_TOTAL;
 }
 
+// Without a reach function every hit is checked against every LED
+bool effect_runner_reactive_splash(uint8_t start, effect_params_t* params, reactive_splash_f effect_func) { return effect_runner_reactive_splash_reach(start, params, effect_func, NULL); }
+
 #endif  // RGB_MATRIX_KEYREACTIVE_ENABLED
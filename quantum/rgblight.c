@@ -186,7 +186,7 @@ void rgblight_check_config(void) {
 
 uint32_t eeconfig_read_rgblight(void) {
 #ifdef EEPROM_ENABLE
-    return eeprom_read_dword(EECONFIG_RGBLIGHT);
+    return eeconfig_read_dword(EECONFIG_RGBLIGHT);
 #else
     return 0;
 #endif
@@ -195,7 +195,7 @@ uint32_t eeconfig_read_rgblight(void) {
 void eeconfig_update_rgblight(uint32_t val) {
 #ifdef EEPROM_ENABLE
     rgblight_check_config();
-    eeprom_update_dword(EECONFIG_RGBLIGHT, val);
+    eeconfig_update_dword(EECONFIG_RGBLIGHT, val);
 #endif
 }
 
@@ -797,13 +797,34 @@ void rgblight_wakeup(void) {
 
 #endif
 
-__attribute__((weak)) void rgblight_call_driver(LED_TYPE *start_led, uint8_t num_leds) { ws2812_setleds(start_led, num_leds); }
+static void rgblight_call_ws2812(LED_TYPE *start_led, uint8_t num_leds) { ws2812_setleds(start_led, num_leds); }
+
+void rgblight_call_driver(LED_TYPE *start_led, uint8_t num_leds) __attribute__((weak, alias("rgblight_call_ws2812")));
 
 #ifndef RGBLIGHT_CUSTOM_DRIVER
 
+static void rgblight_call_driver_rgbw(LED_TYPE *start_led, uint8_t num_leds) {
+#    ifdef RGBW
+    for (uint8_t i = 0; i < num_leds; i++) {
+        convert_rgb_to_rgbw(&start_led[i]);
+    }
+#    endif
+    rgblight_call_driver(start_led, num_leds);
+}
+
+#    ifdef RGBLIGHT_LED_MAP
+// Drivers that replace rgblight_call_driver() are handed a remapped copy of the LEDs
+static __attribute__((noinline)) void rgblight_call_driver_remapped(uint8_t num_leds) {
+    LED_TYPE led0[RGBLED_NUM];
+    for (uint8_t i = 0; i < RGBLED_NUM; i++) {
+        led0[i] = led[pgm_read_byte(&led_map[i])];
+    }
+    rgblight_call_driver_rgbw(led0 + rgblight_ranges.clipping_start_pos, num_leds);
+}
+#    endif
+
 void rgblight_set(void) {
-    LED_TYPE *start_led;
-    uint8_t   num_leds = rgblight_ranges.clipping_num_leds;
+    uint8_t num_leds = rgblight_ranges.clipping_num_leds;
 
     if (!rgblight_config.enable) {
         for (uint8_t i = rgblight_ranges.effect_start_pos; i < rgblight_ranges.effect_end_pos; i++) {
@@ -828,22 +849,23 @@ void rgblight_set(void) {
     }
 #    endif
 
-#    ifdef RGBLIGHT_LED_MAP
-    LED_TYPE led0[RGBLED_NUM];
-    for (uint8_t i = 0; i < RGBLED_NUM; i++) {
-        led0[i] = led[pgm_read_byte(&led_map[i])];
+#    if defined(RGBLIGHT_WS2812) && (defined(RGBLIGHT_LED_MAP) || defined(RGBW))
+    // The stock driver remaps and converts the LEDs as it encodes them
+    if (rgblight_call_driver == rgblight_call_ws2812) {
+#        ifdef RGBLIGHT_LED_MAP
+        ws2812_setleds_mapped(led, led_map + rgblight_ranges.clipping_start_pos, num_leds);
+#        else
+        ws2812_setleds_mapped(led + rgblight_ranges.clipping_start_pos, NULL, num_leds);
+#        endif
+        return;
     }
-    start_led = led0 + rgblight_ranges.clipping_start_pos;
-#    else
-    start_led = led + rgblight_ranges.clipping_start_pos;
 #    endif
 
-#    ifdef RGBW
-    for (uint8_t i = 0; i < num_leds; i++) {
-        convert_rgb_to_rgbw(&start_led[i]);
-    }
+#    ifdef RGBLIGHT_LED_MAP
+    rgblight_call_driver_remapped(num_leds);
+#    else
+    rgblight_call_driver_rgbw(led + rgblight_ranges.clipping_start_pos, num_leds);
 #    endif
-    rgblight_call_driver(start_led, num_leds);
 }
 #endif
 
@@ -24,6 +24,9 @@ SOFTWARE.
 
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
 extern "C" {
 #include "serial_link/protocol/frame_validator.h"
 }
@@ -98,3 +101,48 @@ TEST_F(FrameValidator, sends_five_bytes_with_correct_crc) {
     EXPECT_CALL(*this, byte_stuffer_send_frame(_, _, _)).With(Args<1, 2>(ElementsAreArray(expected)));
     validator_send_frame(0, original, 5);
 }
+
+static uint32_t reference_crc32(const uint8_t* data, uint16_t size) {
+    uint32_t crc = 0xFFFFFFFF;
+    while (size--) {
+        crc ^= *data++;
+        for (int i = 0; i < 8; i++) {
+            crc = (crc >> 1) ^ (crc & 1 ? 0xEDB88320 : 0);
+        }
+    }
+    return ~crc;
+}
+
+TEST_F(FrameValidator, validates_frames_of_any_length_and_alignment) {
+    uint8_t buffer[64 + 4 + 4];
+    EXPECT_CALL(*this, route_incoming_frame(_, _, _)).Times(64 * 4);
+    for (uint16_t size = 1; size <= 64; size++) {
+        for (uint8_t offset = 0; offset < 4; offset++) {
+            uint8_t* data = buffer + offset;
+            for (uint16_t i = 0; i < size; i++) {
+                data[i] = (uint8_t)(i * 37 + size + offset);
+            }
+            uint32_t crc = reference_crc32(data, size);
+            memcpy(data + size, &crc, 4);
+            validator_recv_frame(0, data, size + 4);
+        }
+    }
+}
+
+TEST_F(FrameValidator, crc_throughput) {
+    const uint16_t size       = 1024;
+    const int      iterations = 10000;
+    uint8_t        data[size + 4];
+    for (uint16_t i = 0; i < size + 4; i++) {
+        data[i] = (uint8_t)(i * 13);
+    }
+    // an invalid crc, so nothing gets routed and only the crc is measured
+    EXPECT_CALL(*this, route_incoming_frame(_, _, _)).Times(0);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        validator_recv_frame(0, data, size + 4);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    printf("  crc32: %.1f MB/s\n", size * (double)iterations / elapsed.count() / 1e6);
+}
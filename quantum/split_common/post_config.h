@@ -16,4 +16,8 @@
 // When using serial and RGBLIGHT_SPLIT need separate transaction
 #        define SERIAL_USE_MULTI_TRANSACTION
 #    endif
+#    if defined(SPLIT_TRANSPORT_ON_CHANGE) && !defined(SERIAL_USE_MULTI_TRANSACTION)
+// The change poll is its own transaction
+#        define SERIAL_USE_MULTI_TRANSACTION
+#    endif
 #endif
@@ -0,0 +1,16 @@
+split_transport_sim_INC := \
+	$(QUANTUM_PATH)/split_common/tests \
+	$(DRIVER_PATH)/chibios
+
+split_transport_sim_DEFS := -DSPLIT_USER_M2S_SIZE=8 -DSPLIT_USER_S2M_SIZE=8
+
+split_transport_sim_SRC := \
+	$(QUANTUM_PATH)/split_common/tests/split_transport_sim_tests.cpp \
+	$(QUANTUM_PATH)/split_common/tests/split_sim.c \
+	$(QUANTUM_PATH)/split_common/tests/split_sim_master.c \
+	$(QUANTUM_PATH)/split_common/tests/split_sim_slave.c \
+	$(TMK_PATH)/common/test/timer.c
+
+split_transport_sim_on_change_DEFS := $(split_transport_sim_DEFS) -DSPLIT_TRANSPORT_ON_CHANGE -DSERIAL_USE_MULTI_TRANSACTION
+split_transport_sim_on_change_INC := $(split_transport_sim_INC)
+split_transport_sim_on_change_SRC := $(split_transport_sim_SRC)
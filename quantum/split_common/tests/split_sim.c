@@ -0,0 +1,122 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "split_sim.h"
+#include "serial.h"
+
+void set_time(uint32_t t);
+
+static split_sim_config_t sim_config;
+static split_sim_stats_t  sim_stats;
+static uint64_t           sim_now_us;
+static uint32_t           sim_rand_state;
+
+static SSTD_t *initiator_table      = NULL;
+static int     initiator_table_size = 0;
+static SSTD_t *target_table         = NULL;
+static int     target_table_size    = 0;
+
+static uint32_t sim_rand(void) {
+    // xorshift32, deterministic for a given seed
+    sim_rand_state ^= sim_rand_state << 13;
+    sim_rand_state ^= sim_rand_state >> 17;
+    sim_rand_state ^= sim_rand_state << 5;
+    return sim_rand_state;
+}
+
+static bool sim_chance(uint16_t per_mille) { return per_mille && (sim_rand() % 1000) < per_mille; }
+
+void split_sim_init(const split_sim_config_t *config) {
+    sim_config     = *config;
+    sim_rand_state = config->seed ? config->seed : 1;
+    sim_now_us     = 0;
+    memset(&sim_stats, 0, sizeof(sim_stats));
+    set_time(0);
+}
+
+uint64_t split_sim_now(void) { return sim_now_us; }
+
+void split_sim_advance(uint32_t us) {
+    sim_now_us += us;
+    set_time((uint32_t)(sim_now_us / 1000));
+}
+
+const split_sim_stats_t *split_sim_stats(void) { return &sim_stats; }
+
+static void sim_link_busy(uint32_t us) {
+    sim_stats.busy_us += us;
+    split_sim_advance(us);
+}
+
+void soft_serial_initiator_init(SSTD_t *sstd_table, int sstd_table_size) {
+    initiator_table      = sstd_table;
+    initiator_table_size = sstd_table_size;
+}
+
+void soft_serial_target_init(SSTD_t *sstd_table, int sstd_table_size) {
+    target_table      = sstd_table;
+    target_table_size = sstd_table_size;
+}
+
+#ifndef SERIAL_USE_MULTI_TRANSACTION
+int soft_serial_transaction(void) {
+    int sstd_index = 0;
+#else
+int soft_serial_transaction(int sstd_index) {
+#endif
+    if (sstd_index >= initiator_table_size || sstd_index >= target_table_size) {
+        return TRANSACTION_TYPE_ERROR;
+    }
+
+    SSTD_t *initiator = &initiator_table[sstd_index];
+    SSTD_t *target    = &target_table[sstd_index];
+
+    sim_stats.transactions++;
+
+    if (sim_chance(sim_config.drop_per_mille)) {
+        sim_stats.dropped++;
+        sim_link_busy(sim_config.timeout_us);
+        return TRANSACTION_NO_RESPONSE;
+    }
+
+    // handshake token out and back, then both payloads
+    uint32_t bytes = 2 + initiator->initiator2target_buffer_size + initiator->target2initiator_buffer_size;
+    sim_stats.bytes += bytes;
+    sim_link_busy(sim_config.latency_us + (uint32_t)((uint64_t)bytes * sim_config.bits_per_byte * 1000000 / sim_config.bit_rate));
+
+    if (sim_chance(sim_config.corrupt_per_mille)) {
+        // caught by the checksum, nothing gets committed on either side
+        sim_stats.corrupted++;
+        if (target->status) {
+            *target->status = TRANSACTION_DATA_ERROR;
+        }
+        return TRANSACTION_DATA_ERROR;
+    }
+
+    if (initiator->initiator2target_buffer_size) {
+        memcpy(target->initiator2target_buffer, initiator->initiator2target_buffer, initiator->initiator2target_buffer_size);
+    }
+    if (initiator->target2initiator_buffer_size) {
+        memcpy(initiator->target2initiator_buffer, target->target2initiator_buffer, initiator->target2initiator_buffer_size);
+    }
+    if (target->status) {
+        *target->status = TRANSACTION_ACCEPTED;
+    }
+
+    return TRANSACTION_END;
+}
@@ -0,0 +1,68 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+#include "matrix.h"
+#include "../transport.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ROWS_PER_HAND (MATRIX_ROWS / 2)
+
+// Simulated soft serial / USART link between the two halves
+typedef struct {
+    uint32_t bit_rate;           // bits per second on the wire
+    uint8_t  bits_per_byte;      // framing, e.g. start + 8 data + parity + 2 stop = 12
+    uint32_t latency_us;         // fixed turnaround cost of every transaction
+    uint32_t timeout_us;         // time the initiator waits before giving up on a dropped frame
+    uint16_t drop_per_mille;     // chance of a transaction getting no response
+    uint16_t corrupt_per_mille;  // chance of a frame failing its checksum
+    uint32_t seed;
+} split_sim_config_t;
+
+typedef struct {
+    uint32_t transactions;
+    uint32_t dropped;
+    uint32_t corrupted;
+    uint32_t bytes;
+    uint64_t busy_us;
+} split_sim_stats_t;
+
+void                     split_sim_init(const split_sim_config_t *config);
+uint64_t                 split_sim_now(void);
+void                     split_sim_advance(uint32_t us);
+const split_sim_stats_t *split_sim_stats(void);
+
+// transport.c, built once per half
+void split_sim_master_init(void);
+bool split_sim_master_transport(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]);
+void split_sim_slave_init(void);
+void split_sim_slave_transport(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]);
+int8_t split_sim_master_user_transaction_register(const split_user_transaction_t *transaction);
+int8_t split_sim_slave_user_transaction_register(const split_user_transaction_t *transaction);
+
+// Most the slave's synced time has lagged the master's, in ms
+int32_t split_sim_slave_sync_timer_lag(void);
+
+#ifdef __cplusplus
+}
+#endif
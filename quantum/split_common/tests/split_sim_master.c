@@ -0,0 +1,47 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Builds quantum/split_common/transport.c as the master half. Every global it
+// defines is renamed so both halves can live in the same process.
+#define serial_s2m_buffer split_sim_master_s2m_buffer
+#define serial_m2s_buffer split_sim_master_m2s_buffer
+#define status0 split_sim_master_status0
+#define serial_slave_seq split_sim_master_slave_seq
+#define status_slave_seq split_sim_master_status_slave_seq
+#define transactions split_sim_master_transactions
+#define transport_master_init split_sim_master_transport_master_init
+#define transport_slave_init split_sim_master_transport_slave_init
+#define transport_master split_sim_master_transport_master
+#define transport_slave split_sim_master_transport_slave
+#define split_user_transaction_register split_sim_master_user_transaction_register
+#define split_user_transaction_send_now split_sim_master_user_transaction_send_now
+
+#include "../transport.c"
+
+#include "split_sim.h"
+
+void split_sim_master_init(void) {
+    memset((void *)&serial_s2m_buffer, 0, sizeof(serial_s2m_buffer));
+    memset((void *)&serial_m2s_buffer, 0, sizeof(serial_m2s_buffer));
+#ifdef SPLIT_USER_TRANSACTIONS
+    user_count    = 0;
+    user_used_m2s = 0;
+    user_used_s2m = 0;
+#endif
+    transport_master_init();
+}
+
+bool split_sim_master_transport(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) { return transport_master(master_matrix, slave_matrix); }
@@ -0,0 +1,289 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+
+extern "C" {
+#include "split_sim.h"
+}
+
+namespace {
+const uint8_t      key_row = 1;
+const matrix_row_t key_col = 1 << 3;
+
+split_sim_config_t link_config(uint32_t bit_rate) {
+    split_sim_config_t config = {};
+    config.bit_rate           = bit_rate;
+    config.bits_per_byte      = 12;
+    config.latency_us         = 20;
+    config.timeout_us         = 1000;
+    config.seed               = 42;
+    return config;
+}
+}  // namespace
+
+class SplitTransportSim : public testing::Test {
+   protected:
+    struct Result {
+        uint32_t delivered        = 0;
+        uint64_t total_latency_us = 0;
+        uint64_t max_latency_us   = 0;
+        uint64_t max_transport_us = 0;
+        uint32_t scans            = 0;
+        uint32_t failed_scans     = 0;
+        uint32_t bytes            = 0;
+        uint64_t busy_us          = 0;
+        uint64_t elapsed_us       = 0;
+
+        double avg_latency_us() const { return delivered ? (double)total_latency_us / delivered : 0; }
+        double utilization() const { return elapsed_us ? (double)busy_us / elapsed_us : 0; }
+        double bytes_per_scan() const { return scans ? (double)bytes / scans : 0; }
+    };
+
+    split_sim_config_t config;
+
+    void start(const split_sim_config_t& link) {
+        config = link;
+        split_sim_init(&config);
+        split_sim_master_init();
+        split_sim_slave_init();
+    }
+
+    // Press and release a single slave side key `presses` times. A press counts
+    // as delivered at the end of the master scan whose slave matrix contains it,
+    // which is when the USB report would go out.
+    Result run(uint32_t presses, uint32_t max_scans, uint32_t scan_us = 500, uint32_t slave_scan_us = 400, uint32_t idle_us = 20000) {
+        matrix_row_t master_local[ROWS_PER_HAND] = {0};
+        matrix_row_t slave_mirror[ROWS_PER_HAND] = {0};
+        matrix_row_t slave_local[ROWS_PER_HAND]  = {0};
+        matrix_row_t slave_view[ROWS_PER_HAND]   = {0};
+
+        Result   result;
+        uint64_t start_bytes     = split_sim_stats()->bytes;
+        uint64_t start_busy_us   = split_sim_stats()->busy_us;
+        uint64_t start_us        = split_sim_now();
+        uint64_t next_slave_scan = start_us;
+        uint64_t press_at        = presses ? start_us + idle_us : UINT64_MAX;
+
+        while (result.scans < max_scans && (presses == 0 || result.delivered < presses)) {
+            // local matrix scan on the master
+            split_sim_advance(scan_us);
+
+            // the slave keeps running its own loop in the meantime
+            while (next_slave_scan <= split_sim_now()) {
+                slave_local[key_row] = next_slave_scan >= press_at ? key_col : 0;
+                split_sim_slave_transport(slave_mirror, slave_local);
+                next_slave_scan += slave_scan_us;
+            }
+
+            uint64_t transport_at = split_sim_now();
+            bool     ok           = split_sim_master_transport(master_local, slave_view);
+            if (split_sim_now() - transport_at > result.max_transport_us) {
+                result.max_transport_us = split_sim_now() - transport_at;
+            }
+            result.scans++;
+            if (!ok) {
+                result.failed_scans++;
+            } else if ((slave_view[key_row] & key_col) && split_sim_now() >= press_at) {
+                uint64_t latency = split_sim_now() - press_at;
+                result.delivered++;
+                result.total_latency_us += latency;
+                if (latency > result.max_latency_us) {
+                    result.max_latency_us = latency;
+                }
+                press_at = split_sim_now() + idle_us;
+            }
+        }
+
+        const split_sim_stats_t* stats = split_sim_stats();
+        result.bytes                   = stats->bytes - start_bytes;
+        result.busy_us                 = stats->busy_us - start_busy_us;
+        result.elapsed_us              = split_sim_now() - start_us;
+
+        printf("  %7u bps: %u/%u delivered, latency avg %.0fus max %lluus, %.1f bytes/scan, link %.1f%% busy\n", (unsigned)config.bit_rate, (unsigned)result.delivered, (unsigned)presses, result.avg_latency_us(), (unsigned long long)result.max_latency_us, result.bytes_per_scan(), result.utilization() * 100);
+        return result;
+    }
+};
+
+TEST_F(SplitTransportSim, DeliversEveryKeyPress) {
+    start(link_config(230400));
+    Result result = run(20, 10000);
+    EXPECT_EQ(result.delivered, 20);
+    EXPECT_EQ(result.failed_scans, 0);
+    // within a couple of scans of each half, plus the transfers made in them.
+    // A full transfer carries the user transaction areas too, so it takes
+    // longer than either scan here.
+    EXPECT_LT(result.max_latency_us, 2 * (500 + 400 + result.max_transport_us));
+}
+
+TEST_F(SplitTransportSim, SlowerLinkCostsLatencyAndBandwidth) {
+    start(link_config(230400));
+    Result fast = run(20, 10000);
+    start(link_config(19200));
+    Result slow = run(20, 10000);
+    EXPECT_EQ(fast.delivered, 20);
+    EXPECT_EQ(slow.delivered, 20);
+    EXPECT_GT(slow.avg_latency_us(), fast.avg_latency_us());
+    EXPECT_GT(slow.utilization(), fast.utilization());
+}
+
+TEST_F(SplitTransportSim, RecoversFromDroppedFrames) {
+    split_sim_config_t config = link_config(230400);
+    config.drop_per_mille     = 100;
+    start(config);
+    Result result = run(20, 10000);
+    EXPECT_EQ(result.delivered, 20);
+    EXPECT_GT(result.failed_scans, 0);
+    EXPECT_GT(split_sim_stats()->dropped, 0);
+}
+
+TEST_F(SplitTransportSim, RecoversFromCorruptedFrames) {
+    split_sim_config_t config = link_config(230400);
+    config.corrupt_per_mille  = 100;
+    start(config);
+    Result result = run(20, 10000);
+    EXPECT_EQ(result.delivered, 20);
+    EXPECT_GT(result.failed_scans, 0);
+    EXPECT_GT(split_sim_stats()->corrupted, 0);
+}
+
+TEST_F(SplitTransportSim, CorruptedFramesAreNeverDelivered) {
+    split_sim_config_t config = link_config(230400);
+    config.corrupt_per_mille  = 1000;
+    start(config);
+    Result result = run(1, 200);
+    EXPECT_EQ(result.delivered, 0);
+    EXPECT_EQ(result.failed_scans, result.scans);
+}
+
+TEST_F(SplitTransportSim, IdleLinkUtilization) {
+    start(link_config(230400));
+    Result result = run(0, 1000);
+    EXPECT_EQ(result.failed_scans, 0);
+#ifdef SPLIT_TRANSPORT_ON_CHANGE
+    // only the one byte change poll, plus the occasional periodic full sync
+    EXPECT_LT(result.bytes_per_scan(), 4);
+#else
+    EXPECT_EQ(split_sim_stats()->transactions, result.scans);
+#endif
+}
+
+// The slave only takes the master's time from a fresh transfer, so its clock
+// keeps running between the full transfers of a quiet link
+TEST_F(SplitTransportSim, SyncTimerStaysCurrent) {
+    start(link_config(230400));
+    Result result = run(0, 4000);
+    EXPECT_EQ(result.failed_scans, 0);
+    EXPECT_LE(split_sim_slave_sync_timer_lag(), 2);
+}
+
+namespace {
+uint8_t m2s_received = 0;
+uint8_t s2m_received = 0;
+void    count_m2s(const void*, uint8_t) { m2s_received++; }
+void    count_s2m(const void*, uint8_t) { s2m_received++; }
+}  // namespace
+
+TEST_F(SplitTransportSim, UserTransactionsShareTheExistingRound) {
+    uint8_t  master_leds[4] = {1, 2, 3, 4};
+    uint8_t  slave_leds[4]  = {0};
+    uint16_t master_sensor  = 0;
+    uint16_t slave_sensor   = 0x1234;
+
+    start(link_config(230400));
+    split_user_transaction_t leds   = {master_leds, sizeof(master_leds), true, true, 0, NULL};
+    split_user_transaction_t sensor = {&master_sensor, sizeof(master_sensor), false, true, 0, count_s2m};
+    EXPECT_EQ(split_sim_master_user_transaction_register(&leds), 0);
+    EXPECT_EQ(split_sim_master_user_transaction_register(&sensor), 1);
+    leds.data        = slave_leds;
+    leds.received    = count_m2s;
+    sensor.data      = &slave_sensor;
+    sensor.received  = NULL;
+    EXPECT_EQ(split_sim_slave_user_transaction_register(&leds), 0);
+    EXPECT_EQ(split_sim_slave_user_transaction_register(&sensor), 1);
+
+    m2s_received  = 0;
+    s2m_received  = 0;
+    Result result = run(0, 10);
+    EXPECT_EQ(memcmp(master_leds, slave_leds, sizeof(slave_leds)), 0);
+    EXPECT_EQ(master_sensor, slave_sensor);
+    EXPECT_EQ(m2s_received, 1);
+    EXPECT_EQ(s2m_received, 1);
+    EXPECT_EQ(result.failed_scans, 0);
+#ifndef SPLIT_TRANSPORT_ON_CHANGE
+    // carried by the regular transfer, no extra transactions
+    EXPECT_EQ(split_sim_stats()->transactions, result.scans);
+#endif
+
+    // on_change: unchanged payloads are not delivered again
+    master_leds[2] = 42;
+    run(0, 10);
+    EXPECT_EQ(slave_leds[2], 42);
+    EXPECT_EQ(m2s_received, 2);
+    EXPECT_EQ(s2m_received, 1);
+}
+
+TEST_F(SplitTransportSim, UserTransactionsAreRateLimited) {
+    uint8_t counter = 0;
+
+    start(link_config(230400));
+    split_user_transaction_t heartbeat = {&counter, sizeof(counter), true, false, 10, count_m2s};
+    split_sim_master_user_transaction_register(&heartbeat);
+    split_sim_slave_user_transaction_register(&heartbeat);
+
+    m2s_received = 0;
+    // 100 scans of at least 500us each, sends are at least 10ms apart
+    Result result = run(0, 100);
+    EXPECT_GE(m2s_received, 1);
+    EXPECT_LE(m2s_received, result.elapsed_us / 10000 + 1);
+}
+
+TEST_F(SplitTransportSim, UserTransactionsFailWhenOutOfRoom) {
+    uint8_t payload[SPLIT_USER_M2S_SIZE];
+
+    start(link_config(230400));
+    split_user_transaction_t too_big = {payload, sizeof(payload), true, true, 0, NULL};
+    EXPECT_EQ(split_sim_master_user_transaction_register(&too_big), -1);
+    too_big.size = sizeof(payload) - 1;
+    EXPECT_EQ(split_sim_master_user_transaction_register(&too_big), 0);
+}
+
+TEST_F(SplitTransportSim, PackedMatrixCarriesEveryBit) {
+    matrix_row_t master_local[ROWS_PER_HAND] = {0};
+    matrix_row_t slave_mirror[ROWS_PER_HAND] = {0};
+    matrix_row_t slave_local[ROWS_PER_HAND]  = {0};
+    matrix_row_t slave_view[ROWS_PER_HAND]   = {0};
+    const matrix_row_t all_cols              = (matrix_row_t)((1ULL << MATRIX_COLS) - 1);
+
+    start(link_config(230400));
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            for (uint8_t i = 0; i < ROWS_PER_HAND; i++) {
+                slave_local[i]  = (i == row) ? (matrix_row_t)(1 << col) : 0;
+                master_local[i] = all_cols & ~slave_local[i];
+            }
+            split_sim_advance(500);
+            split_sim_slave_transport(slave_mirror, slave_local);
+            ASSERT_TRUE(split_sim_master_transport(master_local, slave_view));
+            split_sim_slave_transport(slave_mirror, slave_local);
+            for (uint8_t i = 0; i < ROWS_PER_HAND; i++) {
+                EXPECT_EQ(slave_view[i], slave_local[i]);
+            }
+        }
+    }
+}
@@ -0,0 +1,3 @@
+TEST_LIST +=\
+	split_transport_sim\
+	split_transport_sim_on_change
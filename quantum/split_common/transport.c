@@ -8,6 +8,11 @@
 #define ROWS_PER_HAND (MATRIX_ROWS / 2)
 #define SYNC_TIMER_OFFSET 2
 
+#if defined(SPLIT_TRANSPORT_ON_CHANGE) && !defined(SPLIT_TRANSPORT_SYNC_INTERVAL)
+// Force a full transfer at least this often (ms), even if nothing changed
+#    define SPLIT_TRANSPORT_SYNC_INTERVAL 500
+#endif
+
 #ifdef RGBLIGHT_ENABLE
 #    include "rgblight.h"
 #endif
@@ -29,19 +34,166 @@ static pin_t encoders_pad[] = ENCODERS_PAD_A;
 #    include "rgb_matrix.h"
 #endif
 
+// Matrix halves go over the wire as a bit stream of MATRIX_COLS * ROWS_PER_HAND
+// bits, without the padding of matrix_row_t
+#define PACKED_MATRIX_SIZE ((MATRIX_COLS * ROWS_PER_HAND + 7) / 8)
+
+#if MATRIX_COLS > 24
+typedef uint64_t packed_matrix_acc_t;
+#else
+typedef uint32_t packed_matrix_acc_t;
+#endif
+
+static void matrix_pack(uint8_t packed[], const matrix_row_t rows[]) {
+#if MATRIX_COLS == 8 || MATRIX_COLS == 16 || MATRIX_COLS == 32
+    // no padding, the little endian rows already are the bit stream
+    memcpy(packed, rows, PACKED_MATRIX_SIZE);
+#else
+    packed_matrix_acc_t acc  = 0;
+    uint8_t             bits = 0;
+    for (uint8_t i = 0; i < ROWS_PER_HAND; i++) {
+        acc |= (packed_matrix_acc_t)rows[i] << bits;
+        bits += MATRIX_COLS;
+        while (bits >= 8) {
+            *packed++ = (uint8_t)acc;
+            acc >>= 8;
+            bits -= 8;
+        }
+    }
+    if (bits) {
+        *packed = (uint8_t)acc;
+    }
+#endif
+}
+
+static void matrix_unpack(matrix_row_t rows[], const uint8_t packed[]) {
+#if MATRIX_COLS == 8 || MATRIX_COLS == 16 || MATRIX_COLS == 32
+    memcpy(rows, packed, PACKED_MATRIX_SIZE);
+#else
+    packed_matrix_acc_t acc  = 0;
+    uint8_t             bits = 0;
+    for (uint8_t i = 0; i < ROWS_PER_HAND; i++) {
+        while (bits < MATRIX_COLS) {
+            acc |= (packed_matrix_acc_t)*packed++ << bits;
+            bits += 8;
+        }
+        rows[i] = (matrix_row_t)(acc & (((packed_matrix_acc_t)1 << MATRIX_COLS) - 1));
+        acc >>= MATRIX_COLS;
+        bits -= MATRIX_COLS;
+    }
+#endif
+}
+
+#if defined(SPLIT_USER_M2S_SIZE) || defined(SPLIT_USER_S2M_SIZE)
+#    include "transport.h"
+
+#    define SPLIT_USER_TRANSACTIONS
+#    ifndef SPLIT_USER_M2S_SIZE
+#        define SPLIT_USER_M2S_SIZE 0
+#    endif
+#    ifndef SPLIT_USER_S2M_SIZE
+#        define SPLIT_USER_S2M_SIZE 0
+#    endif
+#    ifndef SPLIT_USER_TRANSACTIONS_MAX
+#        define SPLIT_USER_TRANSACTIONS_MAX 8
+#    endif
+
+// Each transaction owns a slot of one sequence byte followed by its payload in
+// the buffer of its direction. The sender bumps the sequence byte whenever it
+// refreshes the payload, the receiver applies the slot when the byte moved.
+static split_user_transaction_t user_transactions[SPLIT_USER_TRANSACTIONS_MAX];
+static uint8_t                  user_offset[SPLIT_USER_TRANSACTIONS_MAX];
+static uint8_t                  user_seq[SPLIT_USER_TRANSACTIONS_MAX];
+static uint16_t                 user_last_send[SPLIT_USER_TRANSACTIONS_MAX];
+static bool                     user_pending[SPLIT_USER_TRANSACTIONS_MAX];
+static uint8_t                  user_count    = 0;
+static uint8_t                  user_used_m2s = 0;
+static uint8_t                  user_used_s2m = 0;
+
+int8_t split_user_transaction_register(const split_user_transaction_t *transaction) {
+    uint8_t *used     = transaction->to_slave ? &user_used_m2s : &user_used_s2m;
+    uint8_t  capacity = transaction->to_slave ? SPLIT_USER_M2S_SIZE : SPLIT_USER_S2M_SIZE;
+
+    if (user_count >= SPLIT_USER_TRANSACTIONS_MAX || *used + 1 + transaction->size > capacity) {
+        return -1;
+    }
+
+    user_transactions[user_count] = *transaction;
+    user_offset[user_count]       = *used;
+    user_seq[user_count]          = 0;
+    user_pending[user_count]      = true;
+    *used += 1 + transaction->size;
+    return user_count++;
+}
+
+void split_user_transaction_send_now(int8_t handle) {
+    if (handle >= 0 && handle < user_count) {
+        user_pending[handle] = true;
+    }
+}
+
+// Refresh the slots this half sends, returns true if any of them was updated
+static bool user_transactions_send(uint8_t *buffer, bool to_slave) {
+    bool updated = false;
+    for (uint8_t i = 0; i < user_count; i++) {
+        split_user_transaction_t *transaction = &user_transactions[i];
+        uint8_t *                 slot        = buffer + user_offset[i];
+        if (transaction->to_slave != to_slave) {
+            continue;
+        }
+        if (!user_pending[i]) {
+            if (transaction->interval && timer_elapsed(user_last_send[i]) < transaction->interval) {
+                continue;
+            }
+            if (transaction->on_change && memcmp(slot + 1, transaction->data, transaction->size) == 0) {
+                continue;
+            }
+        }
+
+        // payload first, so a concurrent transfer never pairs a new sequence with an old payload
+        memcpy(slot + 1, transaction->data, transaction->size);
+        slot[0]++;
+        user_last_send[i] = timer_read();
+        user_pending[i]   = false;
+        updated           = true;
+    }
+    return updated;
+}
+
+// Apply the slots received from the other half
+static void user_transactions_receive(const uint8_t *buffer, bool to_slave) {
+    for (uint8_t i = 0; i < user_count; i++) {
+        split_user_transaction_t *transaction = &user_transactions[i];
+        const uint8_t *           slot        = buffer + user_offset[i];
+        if (transaction->to_slave != to_slave || slot[0] == user_seq[i]) {
+            continue;
+        }
+
+        user_seq[i] = slot[0];
+        memcpy(transaction->data, slot + 1, transaction->size);
+        if (transaction->received) {
+            transaction->received(transaction->data, transaction->size);
+        }
+    }
+}
+#endif
+
 #if defined(USE_I2C)
 
 #    include "i2c_master.h"
 #    include "i2c_slave.h"
 
 typedef struct _I2C_slave_buffer_t {
+#    ifdef SPLIT_TRANSPORT_ON_CHANGE
+    uint8_t slave_seq;
+#    endif
 #    ifndef DISABLE_SYNC_TIMER
     uint32_t sync_timer;
 #    endif
 #    ifdef SPLIT_TRANSPORT_MIRROR
-    matrix_row_t mmatrix[ROWS_PER_HAND];
+    uint8_t mmatrix[PACKED_MATRIX_SIZE];
 #    endif
-    matrix_row_t smatrix[ROWS_PER_HAND];
+    uint8_t smatrix[PACKED_MATRIX_SIZE];
 #    ifdef SPLIT_MODS_ENABLE
     uint8_t real_mods;
     uint8_t weak_mods;
@@ -69,10 +221,19 @@ typedef struct _I2C_slave_buffer_t {
     rgb_config_t rgb_matrix;
     bool         rgb_suspend_state;
 #    endif
+#    if defined(SPLIT_USER_TRANSACTIONS) && SPLIT_USER_M2S_SIZE > 0
+    uint8_t user_m2s[SPLIT_USER_M2S_SIZE];
+#    endif
+#    if defined(SPLIT_USER_TRANSACTIONS) && SPLIT_USER_S2M_SIZE > 0
+    uint8_t user_s2m[SPLIT_USER_S2M_SIZE];
+#    endif
 } I2C_slave_buffer_t;
 
 static I2C_slave_buffer_t *const i2c_buffer = (I2C_slave_buffer_t *)i2c_slave_reg;
 
+_Static_assert(sizeof(I2C_slave_buffer_t) <= I2C_SLAVE_REG_COUNT, "I2C split transport does not fit the slave registers, raise I2C_SLAVE_REG_COUNT");
+
+#    define I2C_SLAVE_SEQ_START offsetof(I2C_slave_buffer_t, slave_seq)
 #    define I2C_SYNC_TIME_START offsetof(I2C_slave_buffer_t, sync_timer)
 #    define I2C_KEYMAP_MASTER_START offsetof(I2C_slave_buffer_t, mmatrix)
 #    define I2C_KEYMAP_SLAVE_START offsetof(I2C_slave_buffer_t, smatrix)
@@ -87,6 +248,8 @@ static I2C_slave_buffer_t *const i2c_buffer = (I2C_slave_buffer_t *)i2c_slave_re
 #    define I2C_LED_SUSPEND_START offsetof(I2C_slave_buffer_t, led_suspend_state)
 #    define I2C_RGB_MATRIX_START offsetof(I2C_slave_buffer_t, rgb_matrix)
 #    define I2C_RGB_SUSPEND_START offsetof(I2C_slave_buffer_t, rgb_suspend_state)
+#    define I2C_USER_M2S_START offsetof(I2C_slave_buffer_t, user_m2s)
+#    define I2C_USER_S2M_START offsetof(I2C_slave_buffer_t, user_s2m)
 
 #    define TIMEOUT 100
 
@@ -96,9 +259,30 @@ static I2C_slave_buffer_t *const i2c_buffer = (I2C_slave_buffer_t *)i2c_slave_re
 
 // Get rows from other half over i2c
 bool transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
-    i2c_readReg(SLAVE_I2C_ADDRESS, I2C_KEYMAP_SLAVE_START, (void *)slave_matrix, sizeof(i2c_buffer->smatrix), TIMEOUT);
+#    ifdef SPLIT_TRANSPORT_ON_CHANGE
+    // Only fetch the slave matrix/encoders when the slave reports a change
+    static uint8_t  last_seq   = 0;
+    static uint16_t last_fetch = 0;
+    uint8_t         seq;
+    if (i2c_readReg(SLAVE_I2C_ADDRESS, I2C_SLAVE_SEQ_START, (void *)&seq, sizeof(seq), TIMEOUT) < 0) {
+        return false;
+    }
+
+    bool fetch = (seq != last_seq) || (timer_elapsed(last_fetch) > SPLIT_TRANSPORT_SYNC_INTERVAL);
+    if (fetch) {
+        if (i2c_readReg(SLAVE_I2C_ADDRESS, I2C_KEYMAP_SLAVE_START, (void *)i2c_buffer->smatrix, sizeof(i2c_buffer->smatrix), TIMEOUT) < 0) {
+            return false;
+        }
+        last_seq   = seq;
+        last_fetch = timer_read();
+    }
+#    else
+    i2c_readReg(SLAVE_I2C_ADDRESS, I2C_KEYMAP_SLAVE_START, (void *)i2c_buffer->smatrix, sizeof(i2c_buffer->smatrix), TIMEOUT);
+#    endif
+    matrix_unpack(slave_matrix, (uint8_t *)i2c_buffer->smatrix);
 #    ifdef SPLIT_TRANSPORT_MIRROR
-    i2c_writeReg(SLAVE_I2C_ADDRESS, I2C_KEYMAP_MASTER_START, (void *)master_matrix, sizeof(i2c_buffer->mmatrix), TIMEOUT);
+    matrix_pack((uint8_t *)i2c_buffer->mmatrix, master_matrix);
+    i2c_writeReg(SLAVE_I2C_ADDRESS, I2C_KEYMAP_MASTER_START, (void *)i2c_buffer->mmatrix, sizeof(i2c_buffer->mmatrix), TIMEOUT);
 #    endif
 
     // write backlight info
@@ -122,8 +306,13 @@ bool transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[])
 #    endif
 
 #    ifdef ENCODER_ENABLE
-    i2c_readReg(SLAVE_I2C_ADDRESS, I2C_ENCODER_START, (void *)i2c_buffer->encoder_state, sizeof(i2c_buffer->encoder_state), TIMEOUT);
-    encoder_update_raw(i2c_buffer->encoder_state);
+#        ifdef SPLIT_TRANSPORT_ON_CHANGE
+    if (fetch)
+#        endif
+    {
+        i2c_readReg(SLAVE_I2C_ADDRESS, I2C_ENCODER_START, (void *)i2c_buffer->encoder_state, sizeof(i2c_buffer->encoder_state), TIMEOUT);
+        encoder_update_raw(i2c_buffer->encoder_state);
+    }
 #    endif
 
 #    ifdef WPM_ENABLE
@@ -171,6 +360,28 @@ bool transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[])
     i2c_writeReg(SLAVE_I2C_ADDRESS, I2C_RGB_SUSPEND_START, (void *)suspend_state, sizeof(i2c_buffer->rgb_suspend_state), TIMEOUT);
 #    endif
 
+#    if defined(SPLIT_USER_TRANSACTIONS) && SPLIT_USER_M2S_SIZE > 0
+    static bool user_m2s_dirty = false;
+    if (user_transactions_send(i2c_buffer->user_m2s, true)) {
+        user_m2s_dirty = true;
+    }
+    if (user_m2s_dirty) {
+        if (i2c_writeReg(SLAVE_I2C_ADDRESS, I2C_USER_M2S_START, (void *)i2c_buffer->user_m2s, sizeof(i2c_buffer->user_m2s), TIMEOUT) >= 0) {
+            user_m2s_dirty = false;
+        }
+    }
+#    endif
+#    if defined(SPLIT_USER_TRANSACTIONS) && SPLIT_USER_S2M_SIZE > 0
+#        ifdef SPLIT_TRANSPORT_ON_CHANGE
+    if (fetch)
+#        endif
+    {
+        if (i2c_readReg(SLAVE_I2C_ADDRESS, I2C_USER_S2M_START, (void *)i2c_buffer->user_s2m, sizeof(i2c_buffer->user_s2m), TIMEOUT) >= 0) {
+            user_transactions_receive(i2c_buffer->user_s2m, false);
+        }
+    }
+#    endif
+
 #    ifndef DISABLE_SYNC_TIMER
     i2c_buffer->sync_timer = sync_timer_read32() + SYNC_TIMER_OFFSET;
     i2c_writeReg(SLAVE_I2C_ADDRESS, I2C_SYNC_TIME_START, (void *)&i2c_buffer->sync_timer, sizeof(i2c_buffer->sync_timer), TIMEOUT);
@@ -183,9 +394,14 @@ void transport_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[])
     sync_timer_update(i2c_buffer->sync_timer);
 #    endif
     // Copy matrix to I2C buffer
-    memcpy((void *)i2c_buffer->smatrix, (void *)slave_matrix, sizeof(i2c_buffer->smatrix));
+    uint8_t packed[PACKED_MATRIX_SIZE];
+    matrix_pack(packed, slave_matrix);
+#    ifdef SPLIT_TRANSPORT_ON_CHANGE
+    bool changed = memcmp((void *)i2c_buffer->smatrix, packed, sizeof(packed)) != 0;
+#    endif
+    memcpy((void *)i2c_buffer->smatrix, packed, sizeof(packed));
 #    ifdef SPLIT_TRANSPORT_MIRROR
-    memcpy((void *)master_matrix, (void *)i2c_buffer->mmatrix, sizeof(i2c_buffer->mmatrix));
+    matrix_unpack(master_matrix, (uint8_t *)i2c_buffer->mmatrix);
 #    endif
 
 // Read Backlight Info
@@ -202,7 +418,16 @@ void transport_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[])
 #    endif
 
 #    ifdef ENCODER_ENABLE
+#        ifdef SPLIT_TRANSPORT_ON_CHANGE
+    uint8_t encoder_state[NUMBER_OF_ENCODERS];
+    encoder_state_raw(encoder_state);
+    if (memcmp((void *)i2c_buffer->encoder_state, (void *)encoder_state, sizeof(encoder_state)) != 0) {
+        memcpy((void *)i2c_buffer->encoder_state, (void *)encoder_state, sizeof(encoder_state));
+        changed = true;
+    }
+#        else
     encoder_state_raw(i2c_buffer->encoder_state);
+#        endif
 #    endif
 
 #    ifdef WPM_ENABLE
@@ -225,6 +450,24 @@ void transport_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[])
     memcpy((void *)i2c_buffer->rgb_matrix, (void *)rgb_matrix_config, sizeof(i2c_buffer->rgb_matrix));
     rgb_matrix_set_suspend_state(i2c_buffer->rgb_suspend_state);
 #    endif
+
+#    if defined(SPLIT_USER_TRANSACTIONS) && SPLIT_USER_M2S_SIZE > 0
+    user_transactions_receive(i2c_buffer->user_m2s, true);
+#    endif
+#    if defined(SPLIT_USER_TRANSACTIONS) && SPLIT_USER_S2M_SIZE > 0
+    if (user_transactions_send(i2c_buffer->user_s2m, false)) {
+#        ifdef SPLIT_TRANSPORT_ON_CHANGE
+        changed = true;
+#        endif
+    }
+#    endif
+
+#    ifdef SPLIT_TRANSPORT_ON_CHANGE
+    // Bump the sequence only after the buffer holds the new state
+    if (changed) {
+        i2c_buffer->slave_seq++;
+    }
+#    endif
 }
 
 void transport_master_init(void) { i2c_init(); }
@@ -236,13 +479,15 @@ void transport_slave_init(void) { i2c_slave_init(SLAVE_I2C_ADDRESS); }
 #    include "serial.h"
 
 typedef struct _Serial_s2m_buffer_t {
-    // TODO: if MATRIX_COLS > 8 change to uint8_t packed_matrix[] for pack/unpack
-    matrix_row_t smatrix[ROWS_PER_HAND];
+    uint8_t smatrix[PACKED_MATRIX_SIZE];
 
 #    ifdef ENCODER_ENABLE
     uint8_t encoder_state[NUMBER_OF_ENCODERS];
 #    endif
 
+#    if defined(SPLIT_USER_TRANSACTIONS) && SPLIT_USER_S2M_SIZE > 0
+    uint8_t user_s2m[SPLIT_USER_S2M_SIZE];
+#    endif
 } Serial_s2m_buffer_t;
 
 typedef struct _Serial_m2s_buffer_t {
@@ -257,7 +502,7 @@ typedef struct _Serial_m2s_buffer_t {
     uint32_t sync_timer;
 #    endif
 #    ifdef SPLIT_TRANSPORT_MIRROR
-    matrix_row_t mmatrix[ROWS_PER_HAND];
+    uint8_t mmatrix[PACKED_MATRIX_SIZE];
 #    endif
 #    ifdef BACKLIGHT_ENABLE
     uint8_t backlight_level;
@@ -273,6 +518,9 @@ typedef struct _Serial_m2s_buffer_t {
     rgb_config_t rgb_matrix;
     bool         rgb_suspend_state;
 #    endif
+#    if defined(SPLIT_USER_TRANSACTIONS) && SPLIT_USER_M2S_SIZE > 0
+    uint8_t user_m2s[SPLIT_USER_M2S_SIZE];
+#    endif
 } Serial_m2s_buffer_t;
 
 #    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
@@ -296,11 +544,21 @@ volatile Serial_s2m_buffer_t serial_s2m_buffer = {};
 volatile Serial_m2s_buffer_t serial_m2s_buffer = {};
 uint8_t volatile status0                       = 0;
 
+#    ifdef SPLIT_TRANSPORT_ON_CHANGE
+// Incremented by the slave whenever its matrix or encoder state changes,
+// polled by the master to decide whether a full transfer is needed.
+volatile uint8_t serial_slave_seq = 0;
+uint8_t volatile status_slave_seq = 0;
+#    endif
+
 enum serial_transaction_id {
     GET_SLAVE_MATRIX = 0,
 #    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
     PUT_RGBLIGHT,
 #    endif
+#    ifdef SPLIT_TRANSPORT_ON_CHANGE
+    GET_SLAVE_SEQ,
+#    endif
 };
 
 SSTD_t transactions[] = {
@@ -318,6 +576,12 @@ SSTD_t transactions[] = {
             (uint8_t *)&status_rgblight, sizeof(serial_rgblight), (uint8_t *)&serial_rgblight, 0, NULL  // no slave to master transfer
         },
 #    endif
+#    ifdef SPLIT_TRANSPORT_ON_CHANGE
+    [GET_SLAVE_SEQ] =
+        {
+            (uint8_t *)&status_slave_seq, 0, NULL, sizeof(serial_slave_seq), (uint8_t *)&serial_slave_seq  // no master to slave transfer
+        },
+#    endif
 };
 
 void transport_master_init(void) { soft_serial_initiator_init(transactions, TID_LIMIT(transactions)); }
@@ -354,6 +618,32 @@ bool transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[])
     if (soft_serial_transaction() != TRANSACTION_END) {
         return false;
     }
+#    elif defined(SPLIT_TRANSPORT_ON_CHANGE)
+    static uint8_t  last_seq    = 0;
+    static uint16_t last_fetch  = 0;
+    static bool     m2s_pending = true;
+
+    transport_rgblight_master();
+    // Minimal poll: a single byte telling us whether the slave has new data
+    if (soft_serial_transaction(GET_SLAVE_SEQ) != TRANSACTION_END) {
+        return false;
+    }
+    if (m2s_pending || serial_slave_seq != last_seq || timer_elapsed(last_fetch) > SPLIT_TRANSPORT_SYNC_INTERVAL) {
+        uint8_t seq = serial_slave_seq;
+#        ifndef DISABLE_SYNC_TIMER
+        serial_m2s_buffer.sync_timer = sync_timer_read32() + SYNC_TIMER_OFFSET;
+#        endif
+        if (soft_serial_transaction(GET_SLAVE_MATRIX) != TRANSACTION_END) {
+            return false;
+        }
+        last_seq    = seq;
+        last_fetch  = timer_read();
+        m2s_pending = false;
+    }
+
+    // Remember what was last sent so changes on the master side trigger a transfer
+    Serial_m2s_buffer_t previous_m2s;
+    memcpy(&previous_m2s, (void *)&serial_m2s_buffer, sizeof(previous_m2s));
 #    else
     transport_rgblight_master();
     if (soft_serial_transaction(GET_SLAVE_MATRIX) != TRANSACTION_END) {
@@ -361,13 +651,10 @@ bool transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[])
     }
 #    endif
 
-    // TODO:  if MATRIX_COLS > 8 change to unpack()
-    for (int i = 0; i < ROWS_PER_HAND; ++i) {
-        slave_matrix[i] = serial_s2m_buffer.smatrix[i];
+    matrix_unpack(slave_matrix, (uint8_t *)serial_s2m_buffer.smatrix);
 #    ifdef SPLIT_TRANSPORT_MIRROR
-        serial_m2s_buffer.mmatrix[i] = master_matrix[i];
+    matrix_pack((uint8_t *)serial_m2s_buffer.mmatrix, master_matrix);
 #    endif
-    }
 
 #    ifdef BACKLIGHT_ENABLE
     // Write backlight level for slave to read
@@ -400,7 +687,18 @@ bool transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[])
     serial_m2s_buffer.rgb_suspend_state = rgb_matrix_get_suspend_state();
 #    endif
 
-#    ifndef DISABLE_SYNC_TIMER
+#    if defined(SPLIT_USER_TRANSACTIONS) && SPLIT_USER_S2M_SIZE > 0
+    user_transactions_receive((uint8_t *)serial_s2m_buffer.user_s2m, false);
+#    endif
+#    if defined(SPLIT_USER_TRANSACTIONS) && SPLIT_USER_M2S_SIZE > 0
+    user_transactions_send((uint8_t *)serial_m2s_buffer.user_m2s, true);
+#    endif
+
+#    ifdef SPLIT_TRANSPORT_ON_CHANGE
+    if (memcmp(&previous_m2s, (void *)&serial_m2s_buffer, sizeof(previous_m2s)) != 0) {
+        m2s_pending = true;
+    }
+#    elif !defined(DISABLE_SYNC_TIMER)
     serial_m2s_buffer.sync_timer = sync_timer_read32() + SYNC_TIMER_OFFSET;
 #    endif
     return true;
@@ -409,22 +707,42 @@ bool transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[])
 void transport_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
     transport_rgblight_slave();
 #    ifndef DISABLE_SYNC_TIMER
+#        ifdef SPLIT_TRANSPORT_ON_CHANGE
+    // The timer only comes with a full transfer, replaying an old one every
+    // scan would hold the synced clock still until the next
+    if (status0 == TRANSACTION_ACCEPTED) {
+        status0 = TRANSACTION_END;
+        sync_timer_update(serial_m2s_buffer.sync_timer);
+    }
+#        else
     sync_timer_update(serial_m2s_buffer.sync_timer);
+#        endif
 #    endif
 
-    // TODO: if MATRIX_COLS > 8 change to pack()
-    for (int i = 0; i < ROWS_PER_HAND; ++i) {
-        serial_s2m_buffer.smatrix[i] = slave_matrix[i];
+    uint8_t packed[PACKED_MATRIX_SIZE];
+    matrix_pack(packed, slave_matrix);
+#    ifdef SPLIT_TRANSPORT_ON_CHANGE
+    bool changed = memcmp((void *)serial_s2m_buffer.smatrix, packed, sizeof(packed)) != 0;
+#    endif
+    memcpy((void *)serial_s2m_buffer.smatrix, packed, sizeof(packed));
 #    ifdef SPLIT_TRANSPORT_MIRROR
-        master_matrix[i] = serial_m2s_buffer.mmatrix[i];
+    matrix_unpack(master_matrix, (uint8_t *)serial_m2s_buffer.mmatrix);
 #    endif
-    }
 #    ifdef BACKLIGHT_ENABLE
     backlight_set(serial_m2s_buffer.backlight_level);
 #    endif
 
 #    ifdef ENCODER_ENABLE
+#        ifdef SPLIT_TRANSPORT_ON_CHANGE
+    uint8_t encoder_state[NUMBER_OF_ENCODERS];
+    encoder_state_raw(encoder_state);
+    if (memcmp((void *)serial_s2m_buffer.encoder_state, encoder_state, sizeof(encoder_state)) != 0) {
+        memcpy((void *)serial_s2m_buffer.encoder_state, encoder_state, sizeof(encoder_state));
+        changed = true;
+    }
+#        else
     encoder_state_raw((uint8_t *)serial_s2m_buffer.encoder_state);
+#        endif
 #    endif
 
 #    ifdef WPM_ENABLE
@@ -447,6 +765,24 @@ void transport_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[])
     rgb_matrix_config = serial_m2s_buffer.rgb_matrix;
     rgb_matrix_set_suspend_state(serial_m2s_buffer.rgb_suspend_state);
 #    endif
+
+#    if defined(SPLIT_USER_TRANSACTIONS) && SPLIT_USER_M2S_SIZE > 0
+    user_transactions_receive((uint8_t *)serial_m2s_buffer.user_m2s, true);
+#    endif
+#    if defined(SPLIT_USER_TRANSACTIONS) && SPLIT_USER_S2M_SIZE > 0
+    if (user_transactions_send((uint8_t *)serial_s2m_buffer.user_s2m, false)) {
+#        ifdef SPLIT_TRANSPORT_ON_CHANGE
+        changed = true;
+#        endif
+    }
+#    endif
+
+#    ifdef SPLIT_TRANSPORT_ON_CHANGE
+    // Bump the sequence only after the buffer holds the new state
+    if (changed) {
+        serial_slave_seq++;
+    }
+#    endif
 }
 
 #endif
@@ -8,3 +8,22 @@ void transport_slave_init(void);
 // returns false if valid data not received from slave
 bool transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]);
 void transport_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]);
+
+#if defined(SPLIT_USER_M2S_SIZE) || defined(SPLIT_USER_S2M_SIZE)
+// User transactions: fixed size payloads carried inside the regular split
+// transfer, so adding one does not add a round trip. Register the same
+// transactions in the same order on both halves.
+typedef struct {
+    void *   data;       // payload, read on the sending half and updated in place on the receiving half
+    uint8_t  size;       // payload size in bytes
+    bool     to_slave;   // true: master -> slave, false: slave -> master
+    bool     on_change;  // only send when the payload changed since the last send
+    uint16_t interval;   // minimum time in ms between two sends, 0 for no limit
+    void (*received)(const void *data, uint8_t size);  // optional, called on the receiving half
+} split_user_transaction_t;
+
+// returns a handle, or -1 if there's no room left in the transfer buffers
+int8_t split_user_transaction_register(const split_user_transaction_t *transaction);
+// send on the next transfer regardless of on_change and interval
+void split_user_transaction_send_now(int8_t handle);
+#endif
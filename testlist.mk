@@ -3,6 +3,12 @@ FULL_TESTS := $(TEST_LIST)
 
 include $(ROOT_DIR)/quantum/sequencer/tests/testlist.mk
 include $(ROOT_DIR)/quantum/serial_link/tests/testlist.mk
+include $(ROOT_DIR)/quantum/split_common/tests/testlist.mk
+include $(ROOT_DIR)/quantum/rgb_matrix_animations/tests/testlist.mk
+include $(ROOT_DIR)/tmk_core/common/chibios/tests/testlist.mk
+include $(ROOT_DIR)/drivers/oled/tests/testlist.mk
+include $(ROOT_DIR)/quantum/encoder/tests/testlist.mk
+include $(ROOT_DIR)/quantum/audio/tests/testlist.mk
 
 define VALIDATE_TEST_LIST
     ifneq ($1,)
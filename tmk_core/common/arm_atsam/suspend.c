@@ -2,6 +2,7 @@
 #include "i2c_master.h"
 #include "md_rgb_matrix.h"
 #include "suspend.h"
+#include "eeconfig.h"
 
 /** \brief Suspend idle
  *
@@ -27,6 +28,8 @@ __attribute__((weak)) void suspend_power_down_kb(void) { suspend_power_down_user
  * FIXME: needs doc
  */
 void suspend_power_down(void) {
+    eeconfig_flush();
+
 #ifdef RGB_MATRIX_ENABLE
     I2C3733_Control_Set(0);  // Disable LED driver
 #endif
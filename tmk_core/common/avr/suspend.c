@@ -8,6 +8,7 @@
 #include "timer.h"
 #include "led.h"
 #include "host.h"
+#include "eeconfig.h"
 
 #ifdef PROTOCOL_LUFA
 #    include "lufa.h"
@@ -135,6 +136,7 @@ void suspend_power_down(void) {
     if (!vusb_suspended) return;
 #endif
 
+    eeconfig_flush();
     suspend_power_down_kb();
 
 #ifndef NO_SUSPEND_POWER_DOWN
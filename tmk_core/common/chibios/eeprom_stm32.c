@@ -21,19 +21,90 @@
 #include "eeprom_stm32.h"
 /*****************************************************************************
  * Allows to use the internal flash to store non volatile data. To initialize
- * the functionality use the EEPROM_Init() function. Be sure that by reprogramming
- * of the controller just affected pages will be deleted. In other case the non
- * volatile data will be lost.
+ * the functionality use the EEPROM_Init() function. Writes are appended to a
+ * log, so a page is only erased once every FEE_LOG_ENTRIES changed bytes
+ * rather than on every changed byte.
  ******************************************************************************/
 
 /* Private macro -------------------------------------------------------------*/
+#define FEE_LOG_ENTRY_ADDRESS(Entry) (FEE_LOG_BASE_ADDRESS + (uint32_t)(Entry)*4)
+
+// The first log entry tags the pages as holding this layout. Its address is
+// past the snapshot, so the replay skips it, and no half word of the older
+// layout, one byte per half word with 0xFF on top, can look like it.
+#define FEE_LOG_TAG_ADDRESS ((uint16_t)0xFE00)
+#define FEE_LOG_TAG_VALUE ((uint16_t)0x0001)
+
 /* Private variables ---------------------------------------------------------*/
+// Index of the next free entry in the write log
+static uint16_t LogEntry;
+
 /* Functions -----------------------------------------------------------------*/
 
-uint8_t DataBuf[FEE_PAGE_SIZE];
+// RAM copy of the EEPROM contents, all reads are served from here
+uint8_t DataBuf[FEE_SNAPSHOT_SIZE];
+
+static FLASH_Status EEPROM_ErasePages(void) {
+    FLASH_Status FlashStatus = FLASH_COMPLETE;
+    int          page_num    = 0;
+
+    // delete all pages from specified start page to the last page
+    do {
+        FlashStatus = FLASH_ErasePage(FEE_PAGE_BASE_ADDRESS + (page_num * FEE_PAGE_SIZE));
+        page_num++;
+    } while (page_num < FEE_DENSITY_PAGES && FlashStatus == FLASH_COMPLETE);
+
+    LogEntry = 0;
+    return FlashStatus;
+}
+
+// Written before anything else goes into erased pages, so that pages without
+// it are either blank or in the older layout
+static FLASH_Status EEPROM_WriteTag(void) {
+    FLASH_Status FlashStatus = FLASH_ProgramHalfWord(FEE_LOG_ENTRY_ADDRESS(0), FEE_LOG_TAG_ADDRESS);
+    if (FlashStatus == FLASH_COMPLETE) {
+        FlashStatus = FLASH_ProgramHalfWord(FEE_LOG_ENTRY_ADDRESS(0) + 2, FEE_LOG_TAG_VALUE);
+    }
+    LogEntry = 1;
+    return FlashStatus;
+}
+
+/*****************************************************************************
+ *  Load pages without the tag into RAM as the older layout, where byte i is
+ *  the low byte of half word i. Returns false if they are blank.
+ ******************************************************************************/
+static bool EEPROM_ReadLegacy(void) {
+    bool Blank = true;
+    for (uint16_t i = 0; i < FEE_SNAPSHOT_SIZE; i++) {
+        uint16_t word = FLASH_ReadHalfWord(FEE_PAGE_BASE_ADDRESS + i * 2);
+        DataBuf[i]    = word;
+        Blank &= word == FEE_EMPTY_WORD;
+    }
+    return !Blank;
+}
+/*****************************************************************************
+ *  Once the write log is full, erase the reserved Flash Space and write the
+ *  RAM copy back as the new snapshot, leaving an empty log.
+ ******************************************************************************/
+static FLASH_Status EEPROM_Compact(void) {
+    FLASH_Status FlashStatus = EEPROM_ErasePages();
+    if (FlashStatus == FLASH_COMPLETE) {
+        FlashStatus = EEPROM_WriteTag();
+    }
+
+    // Erased flash already reads back as 0xFF, so those bytes are skipped
+    for (uint16_t i = 0; i < FEE_SNAPSHOT_SIZE && FlashStatus == FLASH_COMPLETE; i += 2) {
+        uint16_t word = DataBuf[i] | (DataBuf[i + 1] << 8);
+        if (word != FEE_EMPTY_WORD) {
+            FlashStatus = FLASH_ProgramHalfWord(FEE_PAGE_BASE_ADDRESS + i, word);
+        }
+    }
+    return FlashStatus;
+}
 /*****************************************************************************
- *  Delete Flash Space used for user Data, deletes the whole space between
- *  RW_PAGE_BASE_ADDRESS and the last uC Flash Page
+ *  Load the snapshot into RAM and replay the write log over it. Be sure that
+ *  by reprogramming of the controller just affected pages will be deleted.
+ *  In other case the non volatile data will be lost.
  ******************************************************************************/
 uint16_t EEPROM_Init(void) {
     // unlock flash
@@ -42,63 +113,77 @@ uint16_t EEPROM_Init(void) {
     // Clear Flags
     // FLASH_ClearFlag(FLASH_SR_EOP|FLASH_SR_PGERR|FLASH_SR_WRPERR);
 
+    // Settings stored by older firmware are moved into a snapshot, rather
+    // than being read as garbage and reset
+    if (FLASH_ReadHalfWord(FEE_LOG_ENTRY_ADDRESS(0)) != FEE_LOG_TAG_ADDRESS) {
+        LogEntry = 0;
+        if (EEPROM_ReadLegacy()) {
+            EEPROM_Compact();
+        }
+        return FEE_DENSITY_BYTES;
+    }
+
+    for (uint16_t i = 0; i < FEE_SNAPSHOT_SIZE; i += 2) {
+        uint16_t word  = FLASH_ReadHalfWord(FEE_PAGE_BASE_ADDRESS + i);
+        DataBuf[i]     = word;
+        DataBuf[i + 1] = word >> 8;
+    }
+
+    for (LogEntry = 0; LogEntry < FEE_LOG_ENTRIES; LogEntry++) {
+        uint16_t Address = FLASH_ReadHalfWord(FEE_LOG_ENTRY_ADDRESS(LogEntry));
+        if (Address == FEE_EMPTY_WORD) {
+            break;
+        }
+
+        // An entry cut short by a reset has no value and is skipped
+        uint16_t Value = FLASH_ReadHalfWord(FEE_LOG_ENTRY_ADDRESS(LogEntry) + 2);
+        if (Value != FEE_EMPTY_WORD && Address < FEE_SNAPSHOT_SIZE) {
+            DataBuf[Address] = Value;
+        }
+    }
+
     return FEE_DENSITY_BYTES;
 }
 /*****************************************************************************
  *  Erase the whole reserved Flash Space used for user Data
  ******************************************************************************/
 void EEPROM_Erase(void) {
-    int page_num = 0;
-
-    // delete all pages from specified start page to the last page
-    do {
-        FLASH_ErasePage(FEE_PAGE_BASE_ADDRESS + (page_num * FEE_PAGE_SIZE));
-        page_num++;
-    } while (page_num < FEE_DENSITY_PAGES);
+    EEPROM_ErasePages();
+    memset(DataBuf, 0xFF, sizeof(DataBuf));
 }
 /*****************************************************************************
- *  Writes once data byte to flash on specified address. If a byte is already
- *  written, the whole page must be copied to a buffer, the byte changed and
- *  the manipulated buffer written after PageErase.
+ *  Writes once data byte to flash on specified address. Changed bytes are
+ *  appended to the write log; the pages are only erased once it is full.
  *******************************************************************************/
 uint16_t EEPROM_WriteDataByte(uint16_t Address, uint8_t DataByte) {
     FLASH_Status FlashStatus = FLASH_COMPLETE;
 
-    uint32_t page;
-    int      i;
-
     // exit if desired address is above the limit (e.G. under 2048 Bytes for 4 pages)
     if (Address > FEE_DENSITY_BYTES) {
         return 0;
     }
 
-    // calculate which page is affected (Pagenum1/Pagenum2...PagenumN)
-    page = FEE_ADDR_OFFSET(Address) / FEE_PAGE_SIZE;
-
-    // if current data is 0xFF, the byte is empty, just overwrite with the new one
-    if ((*(__IO uint16_t *)(FEE_PAGE_BASE_ADDRESS + FEE_ADDR_OFFSET(Address))) == FEE_EMPTY_WORD) {
-        FlashStatus = FLASH_ProgramHalfWord(FEE_PAGE_BASE_ADDRESS + FEE_ADDR_OFFSET(Address), (uint16_t)(0x00FF & DataByte));
-    } else {
-        // Copy Page to a buffer
-        memcpy(DataBuf, (uint8_t *)FEE_PAGE_BASE_ADDRESS + (page * FEE_PAGE_SIZE), FEE_PAGE_SIZE);  // !!! Calculate base address for the desired page
+    // check if new data is differ to current data, return if not, proceed if yes
+    if (DataBuf[Address] == DataByte) {
+        return FlashStatus;
+    }
+    DataBuf[Address] = DataByte;
 
-        // check if new data is differ to current data, return if not, proceed if yes
-        if (DataByte == *(__IO uint8_t *)(FEE_PAGE_BASE_ADDRESS + FEE_ADDR_OFFSET(Address))) {
-            return 0;
+    if (LogEntry == FEE_LOG_ENTRIES) {
+        return EEPROM_Compact();
+    }
+    if (LogEntry == 0) {
+        FlashStatus = EEPROM_WriteTag();
+        if (FlashStatus != FLASH_COMPLETE) {
+            return FlashStatus;
         }
+    }
 
-        // manipulate desired data byte in temp data array if new byte is differ to the current
-        DataBuf[FEE_ADDR_OFFSET(Address) % FEE_PAGE_SIZE] = DataByte;
-
-        // Erase Page
-        FlashStatus = FLASH_ErasePage(FEE_PAGE_BASE_ADDRESS + (page * FEE_PAGE_SIZE));
-
-        // Write new data (whole page) to flash if data has been changed
-        for (i = 0; i < (FEE_PAGE_SIZE / 2); i++) {
-            if ((__IO uint16_t)(0xFF00 | DataBuf[FEE_ADDR_OFFSET(i)]) != 0xFFFF) {
-                FlashStatus = FLASH_ProgramHalfWord((FEE_PAGE_BASE_ADDRESS + (page * FEE_PAGE_SIZE)) + (i * 2), (uint16_t)(0xFF00 | DataBuf[FEE_ADDR_OFFSET(i)]));
-            }
-        }
+    // The address goes first, so an entry cut short never has a value
+    uint32_t Entry = FEE_LOG_ENTRY_ADDRESS(LogEntry++);
+    FlashStatus    = FLASH_ProgramHalfWord(Entry, Address);
+    if (FlashStatus == FLASH_COMPLETE) {
+        FlashStatus = FLASH_ProgramHalfWord(Entry + 2, DataByte);
     }
     return FlashStatus;
 }
@@ -106,56 +191,55 @@ uint16_t EEPROM_WriteDataByte(uint16_t Address, uint8_t DataByte) {
  *  Read once data byte from a specified address.
  *******************************************************************************/
 uint8_t EEPROM_ReadDataByte(uint16_t Address) {
-    uint8_t DataByte = 0xFF;
-
-    // Get Byte from specified address
-    DataByte = (*(__IO uint8_t *)(FEE_PAGE_BASE_ADDRESS + FEE_ADDR_OFFSET(Address)));
+    if (Address > FEE_DENSITY_BYTES) {
+        return 0xFF;
+    }
 
-    return DataByte;
+    return DataBuf[Address];
 }
 
 /*****************************************************************************
  *  Wrap library in AVR style functions.
  *******************************************************************************/
 uint8_t eeprom_read_byte(const uint8_t *Address) {
-    const uint16_t p = (const uint32_t)Address;
+    const uint16_t p = (uintptr_t)Address;
     return EEPROM_ReadDataByte(p);
 }
 
 void eeprom_write_byte(uint8_t *Address, uint8_t Value) {
-    uint16_t p = (uint32_t)Address;
+    uint16_t p = (uintptr_t)Address;
     EEPROM_WriteDataByte(p, Value);
 }
 
 void eeprom_update_byte(uint8_t *Address, uint8_t Value) {
-    uint16_t p = (uint32_t)Address;
+    uint16_t p = (uintptr_t)Address;
     EEPROM_WriteDataByte(p, Value);
 }
 
 uint16_t eeprom_read_word(const uint16_t *Address) {
-    const uint16_t p = (const uint32_t)Address;
+    const uint16_t p = (uintptr_t)Address;
     return EEPROM_ReadDataByte(p) | (EEPROM_ReadDataByte(p + 1) << 8);
 }
 
 void eeprom_write_word(uint16_t *Address, uint16_t Value) {
-    uint16_t p = (uint32_t)Address;
+    uint16_t p = (uintptr_t)Address;
     EEPROM_WriteDataByte(p, (uint8_t)Value);
     EEPROM_WriteDataByte(p + 1, (uint8_t)(Value >> 8));
 }
 
 void eeprom_update_word(uint16_t *Address, uint16_t Value) {
-    uint16_t p = (uint32_t)Address;
+    uint16_t p = (uintptr_t)Address;
     EEPROM_WriteDataByte(p, (uint8_t)Value);
     EEPROM_WriteDataByte(p + 1, (uint8_t)(Value >> 8));
 }
 
 uint32_t eeprom_read_dword(const uint32_t *Address) {
-    const uint16_t p = (const uint32_t)Address;
+    const uint16_t p = (uintptr_t)Address;
     return EEPROM_ReadDataByte(p) | (EEPROM_ReadDataByte(p + 1) << 8) | (EEPROM_ReadDataByte(p + 2) << 16) | (EEPROM_ReadDataByte(p + 3) << 24);
 }
 
 void eeprom_write_dword(uint32_t *Address, uint32_t Value) {
-    uint16_t p = (const uint32_t)Address;
+    uint16_t p = (uintptr_t)Address;
     EEPROM_WriteDataByte(p, (uint8_t)Value);
     EEPROM_WriteDataByte(p + 1, (uint8_t)(Value >> 8));
     EEPROM_WriteDataByte(p + 2, (uint8_t)(Value >> 16));
@@ -163,7 +247,7 @@ void eeprom_write_dword(uint32_t *Address, uint32_t Value) {
 }
 
 void eeprom_update_dword(uint32_t *Address, uint32_t Value) {
-    uint16_t p             = (const uint32_t)Address;
+    uint16_t p             = (uintptr_t)Address;
     uint32_t existingValue = EEPROM_ReadDataByte(p) | (EEPROM_ReadDataByte(p + 1) << 8) | (EEPROM_ReadDataByte(p + 2) << 16) | (EEPROM_ReadDataByte(p + 3) << 24);
     if (Value != existingValue) {
         EEPROM_WriteDataByte(p, (uint8_t)Value);
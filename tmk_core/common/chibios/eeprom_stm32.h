@@ -75,7 +75,16 @@
 #define FEE_DENSITY_BYTES ((FEE_PAGE_SIZE / 2) * FEE_DENSITY_PAGES - 1)
 #define FEE_LAST_PAGE_ADDRESS (FEE_PAGE_BASE_ADDRESS + (FEE_PAGE_SIZE * FEE_DENSITY_PAGES))
 #define FEE_EMPTY_WORD ((uint16_t)0xFFFF)
-#define FEE_ADDR_OFFSET(Address) (Address * 2)  // 1Byte per Word will be saved to preserve Flash
+
+// The first half of the pages holds a snapshot of the EEPROM contents, the
+// rest is a log of (address, value) half word pairs that is replayed over it
+// into a RAM copy at startup. Writes are appended to the log, and only once
+// it fills up are the pages erased and the snapshot rewritten from RAM.
+// The first log entry tags this layout; pages still in the older one, a byte
+// per half word, are moved into a snapshot at startup.
+#define FEE_SNAPSHOT_SIZE (FEE_DENSITY_BYTES + 1)
+#define FEE_LOG_BASE_ADDRESS (FEE_PAGE_BASE_ADDRESS + FEE_SNAPSHOT_SIZE)
+#define FEE_LOG_ENTRIES ((FEE_LAST_PAGE_ADDRESS - FEE_LOG_BASE_ADDRESS) / 4)
 
 // Use this function to initialize the functionality
 uint16_t EEPROM_Init(void);
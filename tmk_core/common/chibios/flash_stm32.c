@@ -155,6 +155,13 @@ FLASH_Status FLASH_ProgramHalfWord(uint32_t Address, uint16_t Data) {
     return status;
 }
 
+/**
+ * @brief  Reads a half word at a specified address.
+ * @param  Address: specifies the address to be read.
+ * @retval The half word at Address.
+ */
+uint16_t FLASH_ReadHalfWord(uint32_t Address) { return *(__IO uint16_t*)Address; }
+
 /**
  * @brief  Unlocks the FLASH Program Erase Controller.
  * @param  None
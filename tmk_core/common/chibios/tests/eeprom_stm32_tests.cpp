@@ -0,0 +1,209 @@
+/* Copyright 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "eeprom_stm32.h"
+#include "flash_stm32_mock.h"
+}
+
+#include <vector>
+
+// Size of a 4 layer, 6x16 VIA keymap and where it lives
+#define VIA_KEYMAP_ADDR 64
+#define VIA_KEYMAP_SIZE (4 * 6 * 16 * 2)
+
+// eeconfig_update_rgb_matrix() writes the enable, mode, hsv and speed bytes
+#define RGB_CONFIG_ADDR 24
+#define RGB_CONFIG_SIZE 5
+
+class EepromStm32Test : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        flash_mock_reset();
+        EEPROM_Init();
+        shadow.assign(FEE_SNAPSHOT_SIZE, 0xFF);
+    }
+
+    void write(uint16_t address, uint8_t value) {
+        EXPECT_EQ(EEPROM_WriteDataByte(address, value), FLASH_COMPLETE);
+        shadow[address] = value;
+    }
+
+    void expect_shadow(void) {
+        for (uint16_t i = 0; i < FEE_SNAPSHOT_SIZE; i++) {
+            ASSERT_EQ(EEPROM_ReadDataByte(i), shadow[i]) << "at address " << i;
+        }
+    }
+
+    std::vector<uint8_t> shadow;
+};
+
+TEST_F(EepromStm32Test, FreshFlashReadsErased) {
+    EXPECT_EQ(EEPROM_Init(), FEE_DENSITY_BYTES);
+    expect_shadow();
+}
+
+TEST_F(EepromStm32Test, WriteReadBack) {
+    write(0, 0x12);
+    write(FEE_DENSITY_BYTES, 0x34);
+    write(7, 0x00);
+    expect_shadow();
+    EXPECT_EQ(flash_mock_max_erases, 0);
+}
+
+TEST_F(EepromStm32Test, SurvivesReinit) {
+    write(3, 0xAA);
+    write(3, 0x55);
+    write(900, 0x01);
+    EEPROM_Init();
+    expect_shadow();
+}
+
+TEST_F(EepromStm32Test, UnchangedWriteDoesNotProgram) {
+    write(10, 0x42);
+    uint32_t programs = flash_mock_programs;
+    write(10, 0x42);
+    write(11, 0xFF);
+    EXPECT_EQ(flash_mock_programs, programs);
+}
+
+TEST_F(EepromStm32Test, OutOfRangeWriteIsIgnored) {
+    EXPECT_EQ(EEPROM_WriteDataByte(FEE_DENSITY_BYTES + 1, 0x00), 0);
+    EXPECT_EQ(EEPROM_ReadDataByte(FEE_DENSITY_BYTES + 1), 0xFF);
+    EXPECT_EQ(flash_mock_programs, 0);
+}
+
+TEST_F(EepromStm32Test, CompactionKeepsData) {
+    for (uint32_t i = 0; i < FEE_LOG_ENTRIES * 3 + 17; i++) {
+        write((i * 37) % FEE_SNAPSHOT_SIZE, i);
+    }
+    expect_shadow();
+    EXPECT_EQ(flash_mock_max_erases, 3);
+
+    EEPROM_Init();
+    expect_shadow();
+}
+
+TEST_F(EepromStm32Test, ReinitWithFullLog) {
+    // The first entry tags the layout
+    for (uint32_t i = 0; i < FEE_LOG_ENTRIES - 1; i++) {
+        write(i % 16, i);
+    }
+    EXPECT_EQ(flash_mock_max_erases, 0);
+
+    EEPROM_Init();
+    expect_shadow();
+    write(100, 0x01);
+    EXPECT_EQ(flash_mock_max_erases, 1);
+
+    EEPROM_Init();
+    expect_shadow();
+}
+
+TEST_F(EepromStm32Test, InterruptedWriteKeepsOldValue) {
+    write(5, 0x11);
+
+    // Power is lost after the address of the entry went out
+    flash_mock_program_limit(1);
+    EXPECT_NE(EEPROM_WriteDataByte(5, 0x22), FLASH_COMPLETE);
+    flash_mock_program_limit(-1);
+
+    EEPROM_Init();
+    expect_shadow();
+
+    write(5, 0x33);
+    write(6, 0x44);
+    EEPROM_Init();
+    expect_shadow();
+}
+
+TEST_F(EepromStm32Test, MigratesOlderLayout) {
+    // Older firmware kept byte i in the low byte of half word i, so the
+    // upper half of the EEPROM sits where the log is now
+    flash_mock_reset();
+    const uint16_t addresses[] = {0, 2, 3, 24, 64, 65, FEE_SNAPSHOT_SIZE / 2, FEE_DENSITY_BYTES - 1, FEE_DENSITY_BYTES};
+    for (uint16_t address : addresses) {
+        uint8_t value = address * 7 + 1;
+        ASSERT_EQ(FLASH_ProgramHalfWord(FEE_PAGE_BASE_ADDRESS + address * 2, 0xFF00 | value), FLASH_COMPLETE);
+        shadow[address] = value;
+    }
+
+    EEPROM_Init();
+    expect_shadow();
+    EXPECT_EQ(flash_mock_max_erases, 1);
+
+    // After that the whole log is available again
+    for (uint32_t i = 0; i < FEE_LOG_ENTRIES - 1; i++) {
+        write(i % 16, i);
+    }
+    EEPROM_Init();
+    expect_shadow();
+    EXPECT_EQ(flash_mock_max_erases, 1);
+}
+
+TEST_F(EepromStm32Test, Erase) {
+    write(1, 0x01);
+    EEPROM_Erase();
+    shadow.assign(FEE_SNAPSHOT_SIZE, 0xFF);
+    expect_shadow();
+
+    write(2, 0x02);
+    EEPROM_Init();
+    expect_shadow();
+}
+
+TEST_F(EepromStm32Test, ViaKeymapWorkload) {
+    // Load a default keymap, then remap one key at a time
+    for (uint16_t i = 0; i < VIA_KEYMAP_SIZE; i++) {
+        write(VIA_KEYMAP_ADDR + i, i & 0x7F);
+    }
+    const uint32_t remaps = 2000;
+    for (uint32_t i = 0; i < remaps; i++) {
+        uint16_t key = (i * 131) % (VIA_KEYMAP_SIZE / 2);
+        write(VIA_KEYMAP_ADDR + key * 2, i);
+        write(VIA_KEYMAP_ADDR + key * 2 + 1, i >> 8);
+    }
+    expect_shadow();
+
+    // Every changed byte used to cost an erase of its page
+    uint32_t writes = VIA_KEYMAP_SIZE + remaps * 2;
+    EXPECT_LE(flash_mock_max_erases, writes / FEE_LOG_ENTRIES);
+    printf("VIA keymap: %u byte writes, %u erases per page\n", writes, flash_mock_max_erases);
+
+    EEPROM_Init();
+    expect_shadow();
+}
+
+TEST_F(EepromStm32Test, RgbConfigWorkload) {
+    // Step the hue and occasionally the mode, saving after every step
+    const uint32_t steps = 5000;
+    for (uint32_t i = 0; i < steps; i++) {
+        write(RGB_CONFIG_ADDR + 0, 1);
+        write(RGB_CONFIG_ADDR + 1, 1 + i / 100);
+        write(RGB_CONFIG_ADDR + 2, i * 8);
+        write(RGB_CONFIG_ADDR + 3, 255);
+        write(RGB_CONFIG_ADDR + 4, 127);
+    }
+    expect_shadow();
+
+    EXPECT_LE(flash_mock_max_erases, steps / FEE_LOG_ENTRIES + 1);
+    printf("RGB config: %u saves, %u erases per page\n", steps, flash_mock_max_erases);
+
+    EEPROM_Init();
+    expect_shadow();
+}
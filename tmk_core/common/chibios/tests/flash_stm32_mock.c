@@ -0,0 +1,88 @@
+/* Copyright 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "eeprom_stm32.h"
+#include "flash_stm32_mock.h"
+
+#define FLASH_MOCK_SIZE (FEE_PAGE_SIZE * FEE_DENSITY_PAGES)
+
+static uint8_t  flash[FLASH_MOCK_SIZE];
+static uint32_t page_erases[FEE_DENSITY_PAGES];
+static int32_t  program_limit = -1;
+
+uint32_t flash_mock_max_erases;
+uint32_t flash_mock_programs;
+
+void flash_mock_reset(void) {
+    memset(flash, 0xFF, sizeof(flash));
+    memset(page_erases, 0, sizeof(page_erases));
+    flash_mock_max_erases = 0;
+    flash_mock_programs   = 0;
+    program_limit         = -1;
+}
+
+void flash_mock_program_limit(int32_t count) { program_limit = count; }
+
+FLASH_Status FLASH_WaitForLastOperation(uint32_t Timeout) { return FLASH_COMPLETE; }
+
+FLASH_Status FLASH_ErasePage(uint32_t Page_Address) {
+    uint32_t offset = Page_Address - FEE_PAGE_BASE_ADDRESS;
+    if (Page_Address < FEE_PAGE_BASE_ADDRESS || offset >= FLASH_MOCK_SIZE || offset % FEE_PAGE_SIZE) {
+        return FLASH_BAD_ADDRESS;
+    }
+
+    uint32_t page = offset / FEE_PAGE_SIZE;
+    memset(&flash[offset], 0xFF, FEE_PAGE_SIZE);
+    if (++page_erases[page] > flash_mock_max_erases) {
+        flash_mock_max_erases = page_erases[page];
+    }
+    return FLASH_COMPLETE;
+}
+
+FLASH_Status FLASH_ProgramHalfWord(uint32_t Address, uint16_t Data) {
+    uint32_t offset = Address - FEE_PAGE_BASE_ADDRESS;
+    if (Address < FEE_PAGE_BASE_ADDRESS || offset >= FLASH_MOCK_SIZE || offset % 2) {
+        return FLASH_BAD_ADDRESS;
+    }
+    if (program_limit == 0) {
+        return FLASH_TIMEOUT;
+    }
+    if (program_limit > 0) {
+        program_limit--;
+    }
+
+    // Like the real thing, a half word can only be programmed once per erase
+    if (flash[offset] != 0xFF || flash[offset + 1] != 0xFF) {
+        return FLASH_ERROR_PG;
+    }
+    flash[offset]     = Data;
+    flash[offset + 1] = Data >> 8;
+    flash_mock_programs++;
+    return FLASH_COMPLETE;
+}
+
+uint16_t FLASH_ReadHalfWord(uint32_t Address) {
+    uint32_t offset = Address - FEE_PAGE_BASE_ADDRESS;
+    if (Address < FEE_PAGE_BASE_ADDRESS || offset >= FLASH_MOCK_SIZE) {
+        return FEE_EMPTY_WORD;
+    }
+    return flash[offset] | (flash[offset + 1] << 8);
+}
+
+void FLASH_Unlock(void) {}
+void FLASH_Lock(void) {}
+void FLASH_ClearFlag(uint32_t FLASH_FLAG) {}
@@ -0,0 +1,30 @@
+/* Copyright 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// Erase cycles of the busiest page and half word programs since the last reset
+extern uint32_t flash_mock_max_erases;
+extern uint32_t flash_mock_programs;
+
+// Erases the whole simulated flash and clears the counters
+void flash_mock_reset(void);
+
+// Lets only the next count half word programs through, as if power was lost
+// right after them. A negative count removes the limit.
+void flash_mock_program_limit(int32_t count);
@@ -0,0 +1,14 @@
+eeprom_stm32_f103_INC := \
+	$(TMK_PATH)/common/chibios/tests \
+	$(TMK_PATH)/common/chibios
+
+eeprom_stm32_f103_DEFS := -DEEPROM_EMU_STM32F103xB
+
+eeprom_stm32_f103_SRC := \
+	$(TMK_PATH)/common/chibios/tests/eeprom_stm32_tests.cpp \
+	$(TMK_PATH)/common/chibios/tests/flash_stm32_mock.c \
+	$(TMK_PATH)/common/chibios/eeprom_stm32.c
+
+eeprom_stm32_f303_INC := $(eeprom_stm32_f103_INC)
+eeprom_stm32_f303_DEFS := -DEEPROM_EMU_STM32F303xC
+eeprom_stm32_f303_SRC := $(eeprom_stm32_f103_SRC)
@@ -0,0 +1,3 @@
+TEST_LIST +=\
+	eeprom_stm32_f103\
+	eeprom_stm32_f303
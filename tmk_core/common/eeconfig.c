@@ -1,8 +1,10 @@
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include "eeprom.h"
 #include "eeconfig.h"
 #include "action_layer.h"
+#include "timer.h"
 
 #ifdef STM32_EEPROM_ENABLE
 #    include <hal.h>
@@ -17,6 +19,129 @@
 #    include "haptic.h"
 #endif
 
+#ifndef EECONFIG_WRITE_DELAY
+#    define EECONFIG_WRITE_DELAY 1000
+#endif
+
+// Pending changes to the eeconfig block. Updates only change the RAM copy
+// and mark the bytes they changed, which go out to EEPROM in one go once
+// nothing has changed for EECONFIG_WRITE_DELAY ms. Every other byte is read
+// from EEPROM and left alone, so direct eeprom_update_*() calls on these
+// addresses are not overwritten.
+static uint8_t  eeconfig_pending[EECONFIG_SIZE];
+static uint8_t  eeconfig_dirty[(EECONFIG_SIZE + 7) / 8];
+static bool     eeconfig_any_dirty   = false;
+static uint32_t eeconfig_dirty_timer = 0;
+
+#define EECONFIG_IS_DIRTY(i) (eeconfig_dirty[(i) / 8] & (1 << ((i) % 8)))
+
+/** \brief eeconfig erase
+ *
+ * Erases the whole EEPROM where the driver supports it, along with any pending changes
+ */
+static void eeconfig_erase(void) {
+#ifdef STM32_EEPROM_ENABLE
+    EEPROM_Erase();
+#endif
+#if defined(EEPROM_DRIVER)
+    eeprom_driver_erase();
+#endif
+#if defined(STM32_EEPROM_ENABLE) || defined(EEPROM_DRIVER)
+    memset(eeconfig_dirty, 0, sizeof(eeconfig_dirty));
+    eeconfig_any_dirty = false;
+#endif
+}
+
+/** \brief eeconfig read block
+ *
+ * Reads from EEPROM, with changes that are still pending on top
+ */
+void eeconfig_read_block(void *buf, const void *addr, size_t len) {
+    uintptr_t offset = (uintptr_t)addr;
+    eeprom_read_block(buf, addr, len);
+    if (!eeconfig_any_dirty || offset >= EECONFIG_SIZE) {
+        return;
+    }
+
+    uint8_t *data = buf;
+    for (uintptr_t i = offset; i < offset + len && i < EECONFIG_SIZE; i++) {
+        if (EECONFIG_IS_DIRTY(i)) {
+            data[i - offset] = eeconfig_pending[i];
+        }
+    }
+}
+
+/** \brief eeconfig update block
+ *
+ * Updates the RAM copy for anything within EECONFIG_SIZE, the EEPROM is
+ * written later by eeconfig_task() or eeconfig_flush()
+ */
+void eeconfig_update_block(const void *buf, void *addr, size_t len) {
+    uintptr_t offset = (uintptr_t)addr;
+    if (offset + len > EECONFIG_SIZE) {
+        eeprom_update_block(buf, addr, len);
+        return;
+    }
+
+    uint8_t current[EECONFIG_SIZE];
+    eeconfig_read_block(current, addr, len);
+    if (memcmp(current, buf, len) == 0) {
+        return;
+    }
+
+    const uint8_t *data = buf;
+    for (size_t i = 0; i < len; i++) {
+        if (data[i] != current[i]) {
+            eeconfig_pending[offset + i] = data[i];
+            eeconfig_dirty[(offset + i) / 8] |= 1 << ((offset + i) % 8);
+        }
+    }
+    eeconfig_any_dirty   = true;
+    eeconfig_dirty_timer = timer_read32();
+
+#if EECONFIG_WRITE_DELAY == 0
+    eeconfig_flush();
+#endif
+}
+
+/** \brief eeconfig flush
+ *
+ * Writes any pending changes to EEPROM right away, one run of changed bytes at a time
+ */
+void eeconfig_flush(void) {
+    if (eeconfig_any_dirty) {
+        for (uint8_t start = 0; start < EECONFIG_SIZE; start++) {
+            if (!EECONFIG_IS_DIRTY(start)) {
+                continue;
+            }
+            uint8_t end = start + 1;
+            while (end < EECONFIG_SIZE && EECONFIG_IS_DIRTY(end)) {
+                end++;
+            }
+            eeprom_update_block(&eeconfig_pending[start], (void *)(uintptr_t)start, end - start);
+            start = end;
+        }
+        memset(eeconfig_dirty, 0, sizeof(eeconfig_dirty));
+        eeconfig_any_dirty = false;
+    }
+#if defined(EEPROM_DRIVER)
+    eeprom_driver_flush();
+#endif
+}
+
+/** \brief eeconfig task
+ *
+ * Writes pending changes once they have been left alone for EECONFIG_WRITE_DELAY ms
+ */
+void eeconfig_task(void) {
+    if (eeconfig_any_dirty && timer_elapsed32(eeconfig_dirty_timer) >= EECONFIG_WRITE_DELAY) {
+        eeconfig_flush();
+    }
+#if defined(EEPROM_DRIVER)
+    eeprom_driver_task();
+#endif
+}
+
 /** \brief eeconfig enable
  *
  * FIXME: needs doc
@@ -37,36 +162,31 @@ __attribute__((weak)) void eeconfig_init_kb(void) {
  * FIXME: needs doc
  */
 void eeconfig_init_quantum(void) {
-#ifdef STM32_EEPROM_ENABLE
-    EEPROM_Erase();
-#endif
-#if defined(EEPROM_DRIVER)
-    eeprom_driver_erase();
-#endif
-    eeprom_update_word(EECONFIG_MAGIC, EECONFIG_MAGIC_NUMBER);
-    eeprom_update_byte(EECONFIG_DEBUG, 0);
-    eeprom_update_byte(EECONFIG_DEFAULT_LAYER, 0);
+    eeconfig_erase();
+    eeconfig_update_word(EECONFIG_MAGIC, EECONFIG_MAGIC_NUMBER);
+    eeconfig_update_byte(EECONFIG_DEBUG, 0);
+    eeconfig_update_byte(EECONFIG_DEFAULT_LAYER, 0);
     default_layer_state = 0;
-    eeprom_update_byte(EECONFIG_KEYMAP_LOWER_BYTE, 0);
-    eeprom_update_byte(EECONFIG_KEYMAP_UPPER_BYTE, 0);
-    eeprom_update_byte(EECONFIG_MOUSEKEY_ACCEL, 0);
-    eeprom_update_byte(EECONFIG_BACKLIGHT, 0);
-    eeprom_update_byte(EECONFIG_AUDIO, 0xFF);  // On by default
-    eeprom_update_dword(EECONFIG_RGBLIGHT, 0);
-    eeprom_update_byte(EECONFIG_STENOMODE, 0);
-    eeprom_update_dword(EECONFIG_HAPTIC, 0);
-    eeprom_update_byte(EECONFIG_VELOCIKEY, 0);
-    eeprom_update_dword(EECONFIG_RGB_MATRIX, 0);
-    eeprom_update_word(EECONFIG_RGB_MATRIX_EXTENDED, 0);
+    eeconfig_update_byte(EECONFIG_KEYMAP_LOWER_BYTE, 0);
+    eeconfig_update_byte(EECONFIG_KEYMAP_UPPER_BYTE, 0);
+    eeconfig_update_byte(EECONFIG_MOUSEKEY_ACCEL, 0);
+    eeconfig_update_byte(EECONFIG_BACKLIGHT, 0);
+    eeconfig_update_byte(EECONFIG_AUDIO, 0xFF);  // On by default
+    eeconfig_update_dword(EECONFIG_RGBLIGHT, 0);
+    eeconfig_update_byte(EECONFIG_STENOMODE, 0);
+    eeconfig_update_dword(EECONFIG_HAPTIC, 0);
+    eeconfig_update_byte(EECONFIG_VELOCIKEY, 0);
+    eeconfig_update_dword(EECONFIG_RGB_MATRIX, 0);
+    eeconfig_update_word(EECONFIG_RGB_MATRIX_EXTENDED, 0);
 
     // TODO: Remove once ARM has a way to configure EECONFIG_HANDEDNESS
     //        within the emulated eeprom via dfu-util or another tool
 #if defined INIT_EE_HANDS_LEFT
 #    pragma message "Faking EE_HANDS for left hand"
-    eeprom_update_byte(EECONFIG_HANDEDNESS, 1);
+    eeconfig_update_byte(EECONFIG_HANDEDNESS, 1);
 #elif defined INIT_EE_HANDS_RIGHT
 #    pragma message "Faking EE_HANDS for right hand"
-    eeprom_update_byte(EECONFIG_HANDEDNESS, 0);
+    eeconfig_update_byte(EECONFIG_HANDEDNESS, 0);
 #endif
 
 #if defined(HAPTIC_ENABLE)
@@ -75,10 +195,11 @@ void eeconfig_init_quantum(void) {
     // this is used in case haptic is disabled, but we still want sane defaults
     // in the haptic configuration eeprom. All zero will trigger a haptic_reset
     // when a haptic-enabled firmware is loaded onto the keyboard.
-    eeprom_update_dword(EECONFIG_HAPTIC, 0);
+    eeconfig_update_dword(EECONFIG_HAPTIC, 0);
 #endif
 
     eeconfig_init_kb();
+    eeconfig_flush();
 }
 
 /** \brief eeconfig initialization
@@ -91,121 +212,117 @@ void eeconfig_init(void) { eeconfig_init_quantum(); }
  *
  * FIXME: needs doc
  */
-void eeconfig_enable(void) { eeprom_update_word(EECONFIG_MAGIC, EECONFIG_MAGIC_NUMBER); }
+void eeconfig_enable(void) { eeconfig_update_word(EECONFIG_MAGIC, EECONFIG_MAGIC_NUMBER); }
 
 /** \brief eeconfig disable
  *
  * FIXME: needs doc
  */
 void eeconfig_disable(void) {
-#ifdef STM32_EEPROM_ENABLE
-    EEPROM_Erase();
-#endif
-#if defined(EEPROM_DRIVER)
-    eeprom_driver_erase();
-#endif
-    eeprom_update_word(EECONFIG_MAGIC, EECONFIG_MAGIC_NUMBER_OFF);
+    eeconfig_erase();
+    eeconfig_update_word(EECONFIG_MAGIC, EECONFIG_MAGIC_NUMBER_OFF);
+    eeconfig_flush();
 }
 
 /** \brief eeconfig is enabled
  *
  * FIXME: needs doc
  */
-bool eeconfig_is_enabled(void) { return (eeprom_read_word(EECONFIG_MAGIC) == EECONFIG_MAGIC_NUMBER); }
+bool eeconfig_is_enabled(void) { return (eeconfig_read_word(EECONFIG_MAGIC) == EECONFIG_MAGIC_NUMBER); }
 
 /** \brief eeconfig is disabled
  *
  * FIXME: needs doc
  */
-bool eeconfig_is_disabled(void) { return (eeprom_read_word(EECONFIG_MAGIC) == EECONFIG_MAGIC_NUMBER_OFF); }
+bool eeconfig_is_disabled(void) { return (eeconfig_read_word(EECONFIG_MAGIC) == EECONFIG_MAGIC_NUMBER_OFF); }
 
 /** \brief eeconfig read debug
  *
  * FIXME: needs doc
  */
-uint8_t eeconfig_read_debug(void) { return eeprom_read_byte(EECONFIG_DEBUG); }
+uint8_t eeconfig_read_debug(void) { return eeconfig_read_byte(EECONFIG_DEBUG); }
 /** \brief eeconfig update debug
  *
  * FIXME: needs doc
  */
-void eeconfig_update_debug(uint8_t val) { eeprom_update_byte(EECONFIG_DEBUG, val); }
+void eeconfig_update_debug(uint8_t val) { eeconfig_update_byte(EECONFIG_DEBUG, val); }
 
 /** \brief eeconfig read default layer
  *
  * FIXME: needs doc
  */
-uint8_t eeconfig_read_default_layer(void) { return eeprom_read_byte(EECONFIG_DEFAULT_LAYER); }
+uint8_t eeconfig_read_default_layer(void) { return eeconfig_read_byte(EECONFIG_DEFAULT_LAYER); }
 /** \brief eeconfig update default layer
  *
  * FIXME: needs doc
  */
-void eeconfig_update_default_layer(uint8_t val) { eeprom_update_byte(EECONFIG_DEFAULT_LAYER, val); }
+void eeconfig_update_default_layer(uint8_t val) { eeconfig_update_byte(EECONFIG_DEFAULT_LAYER, val); }
 
 /** \brief eeconfig read keymap
  *
  * FIXME: needs doc
  */
-uint16_t eeconfig_read_keymap(void) { return (eeprom_read_byte(EECONFIG_KEYMAP_LOWER_BYTE) | (eeprom_read_byte(EECONFIG_KEYMAP_UPPER_BYTE) << 8)); }
+uint16_t eeconfig_read_keymap(void) { return (eeconfig_read_byte(EECONFIG_KEYMAP_LOWER_BYTE) | (eeconfig_read_byte(EECONFIG_KEYMAP_UPPER_BYTE) << 8)); }
 /** \brief eeconfig update keymap
  *
  * FIXME: needs doc
  */
 void eeconfig_update_keymap(uint16_t val) {
-    eeprom_update_byte(EECONFIG_KEYMAP_LOWER_BYTE, val & 0xFF);
-    eeprom_update_byte(EECONFIG_KEYMAP_UPPER_BYTE, (val >> 8) & 0xFF);
+    eeconfig_update_byte(EECONFIG_KEYMAP_LOWER_BYTE, val & 0xFF);
+    eeconfig_update_byte(EECONFIG_KEYMAP_UPPER_BYTE, (val >> 8) & 0xFF);
 }
 
 /** \brief eeconfig read audio
  *
  * FIXME: needs doc
  */
-uint8_t eeconfig_read_audio(void) { return eeprom_read_byte(EECONFIG_AUDIO); }
+uint8_t eeconfig_read_audio(void) { return eeconfig_read_byte(EECONFIG_AUDIO); }
 /** \brief eeconfig update audio
  *
  * FIXME: needs doc
  */
-void eeconfig_update_audio(uint8_t val) { eeprom_update_byte(EECONFIG_AUDIO, val); }
+void eeconfig_update_audio(uint8_t val) { eeconfig_update_byte(EECONFIG_AUDIO, val); }
 
 /** \brief eeconfig read kb
  *
  * FIXME: needs doc
  */
-uint32_t eeconfig_read_kb(void) { return eeprom_read_dword(EECONFIG_KEYBOARD); }
+uint32_t eeconfig_read_kb(void) { return eeconfig_read_dword(EECONFIG_KEYBOARD); }
 /** \brief eeconfig update kb
  *
  * FIXME: needs doc
  */
-void eeconfig_update_kb(uint32_t val) { eeprom_update_dword(EECONFIG_KEYBOARD, val); }
+void eeconfig_update_kb(uint32_t val) { eeconfig_update_dword(EECONFIG_KEYBOARD, val); }
 
 /** \brief eeconfig read user
  *
  * FIXME: needs doc
  */
-uint32_t eeconfig_read_user(void) { return eeprom_read_dword(EECONFIG_USER); }
+uint32_t eeconfig_read_user(void) { return eeconfig_read_dword(EECONFIG_USER); }
 /** \brief eeconfig update user
  *
  * FIXME: needs doc
  */
-void eeconfig_update_user(uint32_t val) { eeprom_update_dword(EECONFIG_USER, val); }
+void eeconfig_update_user(uint32_t val) { eeconfig_update_dword(EECONFIG_USER, val); }
 
 /** \brief eeconfig read haptic
  *
  * FIXME: needs doc
  */
-uint32_t eeconfig_read_haptic(void) { return eeprom_read_dword(EECONFIG_HAPTIC); }
+uint32_t eeconfig_read_haptic(void) { return eeconfig_read_dword(EECONFIG_HAPTIC); }
 /** \brief eeconfig update haptic
  *
  * FIXME: needs doc
  */
-void eeconfig_update_haptic(uint32_t val) { eeprom_update_dword(EECONFIG_HAPTIC, val); }
+void eeconfig_update_haptic(uint32_t val) { eeconfig_update_dword(EECONFIG_HAPTIC, val); }
 
 /** \brief eeconfig read split handedness
  *
  * FIXME: needs doc
  */
-bool eeconfig_read_handedness(void) { return !!eeprom_read_byte(EECONFIG_HANDEDNESS); }
+bool eeconfig_read_handedness(void) { return !!eeconfig_read_byte(EECONFIG_HANDEDNESS); }
 /** \brief eeconfig update split handedness
  *
  * FIXME: needs doc
  */
-void eeconfig_update_handedness(bool val) { eeprom_update_byte(EECONFIG_HANDEDNESS, !!val); }
+void eeconfig_update_handedness(bool val) { eeconfig_update_byte(EECONFIG_HANDEDNESS, !!val); }
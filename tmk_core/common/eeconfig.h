@@ -19,6 +19,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 #ifndef EECONFIG_MAGIC_NUMBER
 #    define EECONFIG_MAGIC_NUMBER (uint16_t)0xFEEA  // When changing, decrement this value to avoid future re-init issues
@@ -73,6 +74,35 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #define EECONFIG_KEYMAP_LOWER_BYTE EECONFIG_KEYMAP
 
+// Updates to the first EECONFIG_SIZE bytes are held in RAM, and reads see
+// them. Only the bytes changed this way are written back, once no further
+// change came in for EECONFIG_WRITE_DELAY ms, on suspend, before jumping to
+// the bootloader, or on eeconfig_flush(). Changes still pending when power
+// is lost are gone.
+void eeconfig_read_block(void *buf, const void *addr, size_t len);
+void eeconfig_update_block(const void *buf, void *addr, size_t len);
+void eeconfig_flush(void);
+void eeconfig_task(void);
+
+static inline uint8_t eeconfig_read_byte(const uint8_t *addr) {
+    uint8_t val;
+    eeconfig_read_block(&val, addr, sizeof(val));
+    return val;
+}
+static inline uint16_t eeconfig_read_word(const uint16_t *addr) {
+    uint16_t val;
+    eeconfig_read_block(&val, addr, sizeof(val));
+    return val;
+}
+static inline uint32_t eeconfig_read_dword(const uint32_t *addr) {
+    uint32_t val;
+    eeconfig_read_block(&val, addr, sizeof(val));
+    return val;
+}
+static inline void eeconfig_update_byte(uint8_t *addr, uint8_t val) { eeconfig_update_block(&val, addr, sizeof(val)); }
+static inline void eeconfig_update_word(uint16_t *addr, uint16_t val) { eeconfig_update_block(&val, addr, sizeof(val)); }
+static inline void eeconfig_update_dword(uint32_t *addr, uint32_t val) { eeconfig_update_block(&val, addr, sizeof(val)); }
+
 bool eeconfig_is_enabled(void);
 bool eeconfig_is_disabled(void);
 
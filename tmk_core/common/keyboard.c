@@ -513,6 +513,8 @@ MATRIX_LOOP_END:
     joystick_task();
 #endif
 
+    eeconfig_task();
+
     // update LED
     if (led_status != host_keyboard_leds()) {
         led_status = host_keyboard_leds();